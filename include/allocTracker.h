@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocTracker.h
+// ========
+// heap allocation counters per subsystem and per frame. Built with
+// TRACK_ALLOCATIONS defined, global operator new/delete and stb_image's
+// allocations are counted under the tag the allocating thread is in;
+// without it nothing is counted and the hooks cost nothing.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+enum class AllocTag
+{
+	Other,
+	Meshes,
+	Textures,
+	Render,
+	Camera
+};
+
+const int ALLOC_TAG_COUNT = 5;
+
+namespace AllocTracker
+{
+	struct Counters
+	{
+		size_t allocations = 0;
+		size_t frees = 0;
+		size_t bytes = 0;			// allocated, not counting what was freed
+		size_t peak = 0;			// most bytes alive at once
+	};
+
+	// whether this build counts at all
+	bool Enabled();
+	const char* Name(AllocTag tag);
+
+	// tag of the calling thread's allocations, returning the one it replaces
+	AllocTag SetTag(AllocTag tag);
+
+	// closes the frame counters and starts the next frame, on the thread reading Frame()
+	void BeginFrame();
+	// of the last closed frame, and since the program started
+	Counters Frame(AllocTag tag);
+	Counters Total(AllocTag tag);
+	// summed over every tag
+	Counters Frame();
+	size_t Live();
+
+	// stb_image's allocator, counted under 'tag' whatever the thread is in
+	void* Malloc(size_t size, AllocTag tag);
+	void* Realloc(void* pointer, size_t size, AllocTag tag);
+	void Free(void* pointer);
+}
+
+// Tags the calling thread's allocations until the end of the scope
+class AllocScope
+{
+
+public:
+	explicit AllocScope(AllocTag tag) : previous(AllocTracker::SetTag(tag)) {}
+	~AllocScope() { AllocTracker::SetTag(previous); }
+
+	AllocScope(const AllocScope&) = delete;
+	AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+	AllocTag previous;
+};
@@ -1,13 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// app.h
+// ========
+// Window, GL context and main loop: the simulation advances in fixed steps
+// and each frame is drawn between the last two of them, so behaviour is the
+// same at 30 or 500 frames per second. Frames can be drawn on a thread of
+// their own that owns the GL context, away from event polling and input.
+///////////////////////////////////////////////////////////////////////////////
+
 #pragma once
-#include<glad/glad.h>
+#include<GL/glew.h>
 #include<GLFW/glfw3.h>
 #include<iostream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <string>
 
 class app {
 public:
 	 int width, height;
 	 const char* title;
+	 GLFWwindow* window = nullptr;
+
+	 // seconds simulated by each update, and the most updates one frame runs to
+	 // catch up before the simulation is allowed to fall behind real time
+	 double timestep = 1.0 / 120.0;
+	 int maxSteps = 8;
+	 // frames per second the loop sleeps down to, 0 = as fast as possible;
+	 // vsync waits for the display on every swap
+	 double frameLimit = 0.0;
+	 bool vsync = true;
+	 // draw only when invalidate() asked for a frame, sleeping on window events in
+	 // between, waking at least every idleTimeout seconds; the last frame stays on screen
+	 bool onDemand = false;
+	 double idleTimeout = 0.25;
+	 // draw on a render thread that owns the GL context, while this thread keeps
+	 // polling events and running update; the two only share what update
+	 // publishes, so render must not read simulation state directly
+	 bool renderThread = false;
+
+	 // runs once per fixed step with the step length in seconds, on the thread
+	 // that called run; stepTime is the time the step ends at, in app seconds
+	 std::function<void(double)> update;
+	 double stepTime = 0.0;
+	 // runs once after each batch of window events, before the steps that are
+	 // due, on the same thread as update; for input coalesced across events
+	 std::function<void()> input;
+	 // draws a frame for the given time in app seconds, on the thread that owns
+	 // the context; the latest step ended at most one step before it, state
+	 // is interpolated from there towards the next
+	 std::function<void(double)> render;
+
 	 app(const char* title, int width, int height);
+	 // creates the window and context, false with the reason printed on failure
+	 bool open();
+	 // loops until the window is asked to close
 	 void run();
+	 // asks for a new frame in on-demand mode; safe to call from any thread
+	 void invalidate();
+
+private:
+	 typedef std::chrono::steady_clock Clock;
+
+	 // runs the steps lag holds, returns how many
+	 int simulate(Clock::duration &lag, Clock::time_point frameStart);
+	 void renderLoop();
+	 void limitFrame(Clock::time_point frameStart) const;
+	 double seconds(Clock::time_point time) const;
+
+	 Clock::time_point start;
+	 Clock::duration step;
+	 std::atomic<bool> redraw{ true };
+	 std::atomic<bool> running{ false };
+	 std::mutex wakeMutex;
+	 std::condition_variable wake;
 };
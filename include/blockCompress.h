@@ -0,0 +1,34 @@
+///////////////////////////////////////////////////////////////////////////////
+// blockCompress.h
+// ========
+// CPU encoder and decoder for the BC1 (DXT1) and BC3 (DXT5) block formats
+//
+//	Everything here is plain CPU code so the encoder can be checked on a
+//	machine without a GPU by decoding its output and measuring PSNR.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+class WorkerPool;
+
+namespace BlockCompress
+{
+	// bytes per 4x4 block
+	const size_t BC1_BLOCK_BYTES = 8;
+	const size_t BC3_BLOCK_BYTES = 16;
+
+	size_t CompressedSize(int width, int height, size_t blockBytes);
+
+	// pixels: tightly packed rows with 'channels' bytes per pixel (3 or 4)
+	void EncodeBC1(const unsigned char* pixels, int width, int height, int channels, unsigned char* out, WorkerPool* workers);
+	void EncodeBC3(const unsigned char* pixels, int width, int height, unsigned char* out, WorkerPool* workers);
+
+	// decode back to tightly packed RGBA rows
+	void DecodeBC1(const unsigned char* blocks, int width, int height, unsigned char* rgba);
+	void DecodeBC3(const unsigned char* blocks, int width, int height, unsigned char* rgba);
+
+	// peak signal-to-noise ratio in dB over the first 'compareChannels' channels
+	double PSNR(const unsigned char* a, int aChannels, const unsigned char* b, int bChannels, int width, int height, int compareChannels);
+}
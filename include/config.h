@@ -0,0 +1,25 @@
+///////////////////////////////////////////////////////////////////////////////
+// config.h
+// ========
+// read engine settings from a simple "key = value" text file
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <map>
+#include <string>
+
+class Config
+{
+
+public:
+	bool Load(const char* path);
+
+	std::string GetString(const std::string &key, const std::string &fallback) const;
+	float GetFloat(const std::string &key, float fallback) const;
+	int GetInt(const std::string &key, int fallback) const;
+	bool GetBool(const std::string &key, bool fallback) const;
+
+private:
+	std::map<std::string, std::string> values;
+};
@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+// deferredRenderer.h
+// ========
+// deferred shading: scene draws fill a G-buffer of albedo, normal and depth,
+// then one full-screen pass lights every covered pixel exactly once
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <glm/glm/glm.hpp>
+
+#include "shaderLibrary.h"
+
+class DeferredRenderer
+{
+
+public:
+
+	// texture units the lighting pass reads the G-buffer from; unit 0 stays with the scene textures
+	static const GLint ALBEDO_UNIT = 1;
+	static const GLint NORMAL_UNIT = 2;
+	static const GLint DEPTH_UNIT = 3;
+
+	// lightingVertexSource/lightingFragmentSource: the full-screen lighting pass
+	bool Initialize(int width, int height, const char* lightingVertexSource, const char* lightingFragmentSource, bool useCache);
+	void Shutdown();
+	void Resize(int width, int height);
+
+	// bind and clear the G-buffer; SHADER_GBUFFER draws until Light() land in it
+	void BeginGeometry();
+	// shade the G-buffer into the default framebuffer, which the caller has cleared
+	void Light(const glm::mat4 &view, const glm::mat4 &projection);
+
+	// the lighting pass, for the per-frame light uniforms every program gets
+	const ShaderLibrary::Program& LightingProgram() const { return lighting; }
+
+private:
+	void CreateTargets();
+	void DestroyTargets();
+
+	ShaderLibrary::Program lighting;
+	GLuint framebuffer = 0;
+	GLuint albedo = 0;		// RGBA8: texture times objectColor
+	GLuint normal = 0;		// RGBA16F: world normal, w the material: 0 unlit, else 1 + 2 (screen light) + 4 (specular)
+	GLuint depth = 0;		// DEPTH24 the lighting pass rebuilds positions from
+	GLuint emptyVao = 0;	// the full-screen triangle comes from gl_VertexID alone
+	int width = 0;
+	int height = 0;
+};
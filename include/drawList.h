@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+// drawList.h
+// ========
+// per-frame draw list of the scene objects: worker threads cull and record
+// slices of the scene in parallel into a persistently mapped buffer, the GL
+// thread then submits the merged packets as one instanced draw each
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <glm/glm/glm.hpp>
+
+#include "frameArena.h"
+
+#include <functional>
+#include <vector>
+
+class WorkerPool;
+
+// An object of the scene; the model matrix is rebuilt from these every frame
+struct SceneObject
+{
+	unsigned mesh;			// index into DrawList::meshes
+	unsigned features;		// ShaderFeature bits of its material
+	glm::vec4 color;
+	glm::vec3 position;
+	float scale;
+	glm::vec3 axis;			// spins about this unit axis
+	float spin;				// radians per second
+};
+
+class DrawList
+{
+
+public:
+
+	// SSBO binding point the instanced shader variants read objects from
+	static const GLuint OBJECT_BINDING = 3;
+
+	// A mesh the objects can use, drawn with glDrawElements or glDrawArrays
+	struct Mesh
+	{
+		GLuint vao;
+		GLsizei count;			// indices, or vertices when not indexed
+		bool indexed;
+		float radius;			// bounding sphere of the unit mesh
+	};
+
+	// Consecutive objects with the same mesh and material: one instanced draw
+	struct Packet
+	{
+		unsigned key;			// features, then mesh, so sorting groups state changes
+		unsigned mesh;
+		unsigned features;
+		GLuint first;			// objectBase of the draw
+		GLsizei count;			// instances
+	};
+
+	// room for maxObjects per frame, a frame in flight on the GPU per ring segment
+	void Initialize(size_t maxObjects);
+	// the same ring in plain memory and no GL calls, for checks without a window
+	void InitializeHeadless(size_t maxObjects);
+	void Shutdown();
+
+	// Cull the objects against the view and write the survivors' model matrix
+	// and colour to the next ring segment, a slice of objects per job, then
+	// merge the slices' packets. GL thread only; blocks only if the GPU still
+	// reads the segment from RING_SEGMENTS frames ago. The packet lists live in
+	// 'arena', so they stay valid until the frame after next begins.
+	void Record(const glm::vec4 planes[6], float time, WorkerPool* workers, FrameArena &arena);
+	// after the frame's last draw from 'packets', so its segment is not reused too early
+	void Finish();
+
+	// objects recorded by the last Record, and how long the recording took
+	size_t VisibleCount() const { return visible; }
+	double RecordMilliseconds() const { return recordMilliseconds; }
+
+	std::vector<Mesh> meshes;
+	std::vector<SceneObject> objects;		// recorded in order, so sort by material and mesh for fewer packets
+	FrameVector<Packet> packets;			// of the last Record, sorted by key
+
+private:
+
+	static const int RING_SEGMENTS = 3;
+	static const int SLICE_OBJECTS = 1024;	// objects per job
+	static const int SLICE_PACKETS = 16;	// reserved per slice, enough for sorted objects
+
+	// layout of one element of the shader's Objects buffer
+	struct ObjectData
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+	};
+
+	// what every slice of the Record under way reads
+	struct RecordParams
+	{
+		const glm::vec4* planes;
+		float time;
+		FrameArena* arena;
+	};
+
+	void RecordSlice(int slice);
+
+	size_t capacity = 0;					// objects per ring segment
+	GLuint buffer = 0;
+	ObjectData* mapped = nullptr;
+	std::vector<ObjectData> headless;		// what 'mapped' points at without a buffer
+	GLsync fences[RING_SEGMENTS] = {};
+	int segment = 0;
+
+	RecordParams params = {};
+	std::function<void(int)> recordSlice;	// the slice job, built once so handing it out never allocates
+	std::vector<FrameVector<Packet>> slicePackets;	// one list per slice, in its worker's arena
+	std::vector<size_t> sliceVisible;
+	size_t visible = 0;
+	double recordMilliseconds = 0.0;
+};
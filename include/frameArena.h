@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameArena.h
+// ========
+// bump allocators for data that lives for a frame: culling output, sort
+// keys, draw packets. Memory is handed out by moving a pointer and taken
+// back all at once when the frame it belongs to starts over, so once the
+// arenas have grown to a frame's worth the heap is never touched again.
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class WorkerPool;
+
+// One thread's arena: allocations bump an offset into a block, Reset frees
+// them all. A frame that outgrows the block gets overflow blocks, and the
+// next Reset replaces them all with a single block large enough for it.
+class alignas(64) LinearArena
+{
+
+public:
+	void Initialize(size_t bytes);
+	void Reset();
+
+	// never returns nullptr; only allocates from the heap while growing
+	void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+	template<class T> T* Allocate(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+
+	// bytes handed out since the last Reset, and the most any frame has used
+	size_t Used() const { return used; }
+	size_t HighWater() const { return highWater; }
+	size_t Capacity() const;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<unsigned char[]> data;
+		size_t size;
+	};
+
+	std::vector<Block> blocks;			// the first, then this frame's overflow
+	size_t offset = 0;					// into the last block
+	size_t used = 0;
+	size_t highWater = 0;
+};
+
+// Standard allocator over a LinearArena, so containers can live in a frame.
+// deallocate is a no-op; a vector that grows leaves its old storage behind
+// until the arena resets, so reserve when the size is known.
+template<class T>
+class ArenaAllocator
+{
+
+public:
+	typedef T value_type;
+	// containers moved or swapped take the arena along with the storage
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	ArenaAllocator() = default;
+	explicit ArenaAllocator(LinearArena* arena) : arena(arena) {}
+	template<class U> ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+	T* allocate(size_t count) { return arena->Allocate<T>(count); }
+	void deallocate(T*, size_t) {}
+
+	template<class U> bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+	template<class U> bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+
+	LinearArena* arena = nullptr;
+};
+
+template<class T> using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// The arenas of two frames, one LinearArena per thread in each. BeginFrame
+// switches frames and resets the one it switches to, so what the previous
+// frame allocated stays valid while this one is built (a frame handed to
+// another thread, or still being submitted, is never overwritten under it).
+class FrameArena
+{
+
+public:
+	// threads: one per worker of 'workers' plus the thread running the frames
+	void Initialize(const WorkerPool* workers, size_t bytesPerThread);
+	// the frame thread only, with no job still allocating from the arena
+	void BeginFrame();
+
+	// the calling thread's arena of the current frame: a worker's own, or the
+	// frame thread's for any other thread, which only the frame thread may use
+	LinearArena& Local();
+
+	// summed over every thread of the current frame
+	size_t Used() const;
+	size_t HighWater() const;
+	size_t Capacity() const;
+
+private:
+	const WorkerPool* workers = nullptr;
+	std::vector<LinearArena> arenas[2];
+	int frame = 0;
+};
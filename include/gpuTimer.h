@@ -0,0 +1,38 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuTimer.h
+// ========
+// GPU time (GL_TIME_ELAPSED) or samples drawn (GL_SAMPLES_PASSED) over a
+// stretch of commands, read back a few frames late so it never stalls
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+class GpuTimer
+{
+
+public:
+	void Initialize(GLenum target = GL_TIME_ELAPSED);
+	void Shutdown();
+
+	// bracket the commands to time; skipped while every query is still in flight
+	void Begin();
+	void End();
+
+	// average of the results that arrived since the last call, false when none did;
+	// milliseconds for GL_TIME_ELAPSED, samples for GL_SAMPLES_PASSED
+	bool Average(double &value);
+
+private:
+	void Collect();
+
+	static const int QUERY_COUNT = 4;
+	GLenum target = GL_TIME_ELAPSED;
+	GLuint queries[QUERY_COUNT] = {};
+	int next = 0;			// query the next Begin starts
+	int inFlight = 0;		// ended but not read back, the oldest is next - inFlight
+	bool timing = false;
+	double total = 0.0;
+	int samples = 0;
+};
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightClusters.h
+// ========
+// clustered forward lighting: point lights sorted into a grid of view-frustum
+// cells (froxels) on the CPU and handed to the fragment shader in SSBOs
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <glm/glm/glm.hpp>
+
+#include "frameArena.h"
+
+#include <vector>
+
+// A point light whose influence fades to nothing at 'radius'
+struct PointLight
+{
+	glm::vec3 position;
+	float radius;
+	glm::vec3 color;
+};
+
+class LightClusters
+{
+
+public:
+
+	// froxel grid: screen tiles in x and y, exponentially spaced depth slices in z
+	static const int GRID_X = 16;
+	static const int GRID_Y = 9;
+	static const int GRID_Z = 24;
+	static const int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+	// light indices share a 32-bit key with the cluster while grouping
+	static const int MAX_LIGHTS = 65536;
+
+	// SSBO binding points the shader declares its light buffers at
+	static const GLuint LIGHT_BINDING = 0;
+	static const GLuint GRID_BINDING = 1;
+	static const GLuint INDEX_BINDING = 2;
+
+	void Initialize();
+	void Shutdown();
+
+	// Assign every light to the clusters its sphere touches for this view, upload
+	// the lists and bind them. Cluster bounds are only rebuilt when the projection changes.
+	// The pairs are grouped in 'scratch', which only has to last until Update returns.
+	void Update(const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane, LinearArena &scratch);
+
+	// tiles per pixel in xy, slices per unit of log depth in z, near plane in w
+	void ShaderScale(int viewportWidth, int viewportHeight, float scale[4]) const;
+
+	// light-cluster pairs written by the last Update
+	size_t AssignedCount() const { return indices.size(); }
+
+	std::vector<PointLight> lights;		// at most MAX_LIGHTS, the rest are ignored
+
+private:
+
+	void BuildBounds(const glm::mat4 &projection);
+	int Slice(float depth) const;
+
+	// view-space bounds of every cluster, one array per component so four
+	// neighbouring clusters are tested against a light at once
+	std::vector<float> boundsMin[3];
+	std::vector<float> boundsMax[3];
+	glm::mat4 boundsProjection = glm::mat4(0.0f);
+	float nearPlane = 0.0f;
+	float farPlane = 0.0f;
+
+	std::vector<glm::vec4> gpuLights;		// position and radius, then color, per light
+	std::vector<unsigned int> grid;			// offset and count into 'indices' per cluster
+	std::vector<unsigned int> indices;		// light indices grouped by cluster
+
+	GLuint buffers[3] = {};
+};
@@ -0,0 +1,36 @@
+///////////////////////////////////////////////////////////////////////////////
+// mappedFile.h
+// ========
+// read-only memory mapping of a whole file, so asset bytes are read straight
+// from the page cache instead of being copied into heap buffers
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class MappedFile
+{
+
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile &operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string &path);
+	void Close();
+
+	const unsigned char* Data() const { return data; }
+	size_t Size() const { return size; }
+
+private:
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
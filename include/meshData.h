@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshData.h
+// ========
+// CPU side of the 3D primitives: generation, optimization, bounds and the
+// on-disk cache under mesh_cache/, with no GL anywhere so it runs headless
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+enum class MeshPrimitive
+{
+	Plane,
+	Prism,
+	Box,
+	Cone,
+	Cylinder,
+	TaperedCylinder,
+	Pyramid3,
+	Pyramid4,
+	Sphere,
+	Torus
+};
+
+const int MESH_PRIMITIVE_COUNT = 10;
+
+// CPU copy of a mesh: position, normal and uv of every vertex interleaved, and
+// triangle indices for meshes drawn with glDrawElements
+struct MeshData
+{
+	static const int FLOATS_PER_VERTEX = 8;
+
+	std::vector<float> vertices;
+	std::vector<unsigned int> indices;		// empty when the vertices are drawn as they come
+	glm::vec3 boundsMin = glm::vec3(0.0f);
+	glm::vec3 boundsMax = glm::vec3(0.0f);
+	float radius = 0.0f;					// bounding sphere about the mesh's origin
+
+	size_t VertexCount() const { return vertices.size() / FLOATS_PER_VERTEX; }
+	bool IsIndexed() const { return !indices.empty(); }
+	size_t ByteCount() const { return vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int); }
+};
+
+namespace MeshLibrary
+{
+	const char* Name(MeshPrimitive primitive);
+
+	// the primitive's geometry, optimized and with its bounds
+	void Generate(MeshPrimitive primitive, MeshData &mesh);
+
+	// weld identical vertices, order the triangles for the post-transform vertex
+	// cache and the vertices by first use; indexed meshes only, since the draw
+	// commands of the others depend on their vertex order
+	void Optimize(MeshData &mesh);
+	void ComputeBounds(MeshData &mesh);
+
+	// from mesh_cache/ when an entry of this version exists, otherwise
+	// generated and, with useCache, written there for the next run
+	void Create(MeshPrimitive primitive, MeshData &mesh, bool useCache);
+
+	std::string EntryPath(MeshPrimitive primitive);
+	bool Load(MeshPrimitive primitive, MeshData &mesh);
+	bool Save(MeshPrimitive primitive, const MeshData &mesh);
+
+	bool Read(const std::string &path, MeshData &mesh);
+	bool Write(const std::string &path, const MeshData &mesh);
+}
@@ -11,8 +11,13 @@
 
 #include <GL/glew.h>
 
-#include <glm/glm/glm.hpp>
+#include "meshData.h"
 
+#include <vector>
+
+class WorkerPool;
+
+// GL side of the primitives: uploads what MeshLibrary generates
 class Meshes
 {
 
@@ -21,40 +26,25 @@ public:
 	// Stores the GL data relative to a given mesh
 	struct GLMesh
 	{
-		GLuint vao;         // Handle for the vertex array object
-		GLuint vbos[2];     // Handles for the vertex buffer objects
-		GLuint nVertices;	// Number of vertices for the mesh
-		GLuint nIndices;    // Number of indices for the mesh
+		GLuint vao = 0;         // Handle for the vertex array object
+		GLuint vbos[2] = {};    // Handles for the vertex buffer objects
+		GLuint nVertices = 0;	// Number of vertices for the mesh
+		GLuint nIndices = 0;    // Number of indices for the mesh
+		float radius = 0.0f;	// bounding sphere about the mesh's origin
 	};
 
-	GLMesh gBoxMesh;
-	GLMesh gConeMesh;
-	GLMesh gCylinderMesh;
-	GLMesh gTaperedCylinderMesh;
-	GLMesh gPlaneMesh;
-	GLMesh gPrismMesh;
-	GLMesh gSphereMesh;
-	GLMesh gPyramid3Mesh;
-	GLMesh gPyramid4Mesh;
-	GLMesh gTorusMesh;
+	// read meshes from mesh_cache/ instead of generating them, writing missing entries
+	bool useCache = true;
 
 public:
-	void CreateMeshes();
+	// only the primitives listed are created, generated in parallel on the workers
+	void CreateMeshes(const std::vector<MeshPrimitive> &primitives, WorkerPool* workers = nullptr);
+	const GLMesh& Get(MeshPrimitive primitive);
 	void DestroyMeshes();
 
 private:
-	void UCreatePlaneMesh(GLMesh &mesh);
-	void UCreatePrismMesh(GLMesh &mesh);
-	void UCreateBoxMesh(GLMesh &mesh);
-	void UCreateConeMesh(GLMesh &mesh);
-	void UCreateCylinderMesh(GLMesh &mesh);
-	void UCreateTaperedCylinderMesh(GLMesh &mesh);
-	void UCreateTorusMesh(GLMesh &mesh);
-	void UCreatePyramid3Mesh(GLMesh &mesh);
-	void UCreatePyramid4Mesh(GLMesh &mesh);
-	void UCreateSphereMesh(GLMesh &mesh);
-
+	static void UUploadMesh(GLMesh &mesh, const MeshData &data);
 	void UDestroyMesh(GLMesh &mesh);
 
-	void CalculateTriangleNormal(glm::vec3 px, glm::vec3 py, glm::vec3 pz);
-};
\ No newline at end of file
+	GLMesh meshes[MESH_PRIMITIVE_COUNT];		// vao 0 until created
+};
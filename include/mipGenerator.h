@@ -0,0 +1,43 @@
+///////////////////////////////////////////////////////////////////////////////
+// mipGenerator.h
+// ========
+// CPU mip chain generation and downscaling with SSE/AVX box, Kaiser and
+// Lanczos filters, computed in linear light for sRGB colour channels
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+class WorkerPool;
+
+enum class MipFilter
+{
+	Box,		// 2x2 average
+	Kaiser		// 8 tap Kaiser windowed sinc, sharper distant detail
+};
+
+enum class ResampleFilter
+{
+	Box,		// average of the covered source pixels
+	Lanczos		// 3 lobe Lanczos, keeps edges crisp
+};
+
+namespace MipGenerator
+{
+	// size of the level below 'size'
+	inline int NextSize(int size) { return size > 1 ? size / 2 : 1; }
+
+	// src: tightly packed rows with 'channels' bytes per pixel (1 to 4)
+	// dst: receives NextSize(width) x NextSize(height) pixels
+	// srgb: colour channels are sRGB encoded and filtered in linear light;
+	//       a fourth channel is always treated as linear alpha
+	void Downsample(const unsigned char* src, int width, int height, int channels, unsigned char* dst,
+		MipFilter filter, bool srgb, WorkerPool* workers);
+
+	// dst: receives outWidth x outHeight pixels, no larger than the source
+	void Resize(const unsigned char* src, int width, int height, int channels, unsigned char* dst,
+		int outWidth, int outHeight, ResampleFilter filter, bool srgb, WorkerPool* workers);
+	bool FitSize(int width, int height, int maxDimension, int &outWidth, int &outHeight);
+
+	const char* FilterName(MipFilter filter);
+	const char* FilterName(ResampleFilter filter);
+}
@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// quaternionCamera.h
+// ========
+// camera with a quaternion orientation whose view, projection,
+// view-projection and frustum planes are cached and rebuilt only after
+// the pose or the lens changed, so any number of readers per frame is free
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm/glm.hpp>
+#include <glm/glm/gtc/quaternion.hpp>
+
+#include <camera.h>
+
+class QuaternionCamera
+{
+
+public:
+	enum Plane { LEFT_PLANE, RIGHT_PLANE, BOTTOM_PLANE, TOP_PLANE, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+	// same start as Camera: looking down -z from above the desk
+	QuaternionCamera(glm::vec3 position = glm::vec3(10.0f, 9.0f, 35.0f));
+
+	// pose; setting either only marks the view dirty when it actually changes
+	const glm::vec3& Position() const { return position; }
+	const glm::quat& Orientation() const { return orientation; }
+	void SetPose(const glm::vec3 &position, const glm::quat &orientation);
+	glm::vec3 Front() const;
+	glm::vec3 Right() const;
+	glm::vec3 Up() const;
+
+	// moves like Camera::ProcessKeyboard, distance in world units
+	void Move(Camera_Movement direction, float distance);
+	// turns like Camera::ProcessMouseMovement: degrees about the world up,
+	// then about the camera's right, pitch held within +-89 degrees
+	void Turn(float yawDegrees, float pitchDegrees);
+
+	// lens; only marks the projection dirty when a value changes
+	void SetPerspective(float fovyDegrees, float aspect, float nearPlane, float farPlane);
+	void SetOrthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane);
+
+	// cached, rebuilt on first use after a change
+	const glm::mat4& View();
+	const glm::mat4& Projection();
+	const glm::mat4& ViewProjection();
+	// world-space planes (xyz normal pointing inwards, w distance), normalized
+	const glm::vec4* FrustumPlanes();
+	// false when the sphere lies entirely outside one of the planes
+	bool SphereVisible(const glm::vec3 &center, float radius);
+
+private:
+	void Refresh();
+
+	glm::vec3 position;
+	glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);	// glm leaves a default quat uninitialised
+	float pitch = 0.0f;			// degrees, kept for the +-89 limit
+
+	bool orthographic = false;
+	float lens[6] = {};			// fovy, aspect, near, far or left, right, bottom, top, near, far
+
+	bool viewDirty = true;
+	bool projectionDirty = true;
+	bool combinedDirty = true;	// view-projection and planes
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::mat4 viewProjection;
+	glm::vec4 planes[PLANE_COUNT];
+};
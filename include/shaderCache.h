@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderCache.h
+// ========
+// on-disk cache of linked shader program binaries, stored under shader_cache/
+// and keyed by the shader sources and the driver that built them
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+
+namespace ShaderCache
+{
+	// hex hash of both sources together with GL_VENDOR, GL_RENDERER and GL_VERSION,
+	// so a driver update or a source edit never picks up a stale binary
+	std::string Key(const char* vertexSource, const char* fragmentSource);
+	std::string EntryPath(const std::string &key);
+
+	// restore 'program' from its cached binary; false when there is no entry or the
+	// driver rejects it, in which case the program is left unlinked for a normal build
+	bool Load(const std::string &key, GLuint program);
+
+	// store the binary of a program linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+	bool Save(const std::string &key, GLuint program);
+}
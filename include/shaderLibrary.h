@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderLibrary.h
+// ========
+// compile-time specialised variants of the scene shader, one program per
+// combination of feature bits, so each draw runs only the math it needs
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+
+// Feature bits a variant is specialised on; each becomes a #define in both stages
+enum ShaderFeature : unsigned
+{
+	SHADER_LIT = 1 << 0,			// ambient and diffuse lighting
+	SHADER_TEXTURED = 1 << 1,		// sample myTexture, otherwise objectColor alone
+	SHADER_SPECULAR = 1 << 2,		// specular highlight of the light bulb
+	SHADER_TWO_LIGHTS = 1 << 3,		// the screen light as well as the bulb
+	SHADER_CLUSTERED = 1 << 4,		// the point lights LightClusters assigned to the fragment's cluster
+	SHADER_GBUFFER = 1 << 5,		// write albedo and normal for DeferredRenderer instead of lighting
+	SHADER_INSTANCED = 1 << 6		// model and colour per instance from the DrawList buffer, at objectBase + gl_InstanceID
+};
+
+const unsigned SHADER_FEATURE_COUNT = 7;
+const unsigned SHADER_VARIANT_COUNT = 1 << SHADER_FEATURE_COUNT;
+// the scene shader as it was before it was split: everything on
+const unsigned SHADER_STANDARD = SHADER_LIT | SHADER_TEXTURED | SHADER_SPECULAR | SHADER_TWO_LIGHTS;
+
+class ShaderLibrary
+{
+
+public:
+
+	// A linked variant and its uniform locations; -1 where the variant optimised one away
+	struct Program
+	{
+		unsigned features = 0;
+		GLuint id = 0;
+		bool ready = false;		// linked and its uniforms looked up
+		GLint model = -1;
+		GLint view = -1;
+		GLint projection = -1;
+		GLint objectColor = -1;
+		GLint uvTransform = -1;
+		GLint lightBulbPos = -1;
+		GLint lightScreenPos = -1;
+		GLint lightBulbColor = -1;
+		GLint lightScreenColor = -1;
+		GLint clusterScale = -1;
+		GLint clusterGrid = -1;
+		GLint inverseViewProjection = -1;
+		GLint objectBase = -1;
+	};
+
+	// Start compiling every distinct variant of the two sources and wait for the
+	// fallbacks only; false if one of those failed. With KHR_parallel_shader_compile
+	// the rest finish in the background and are picked up by Update; without it
+	// Update finishes a few each frame. With useCache, programs come from ShaderCache.
+	bool Build(const char* vertexSource, const char* fragmentSource, bool useCache);
+	void Destroy();
+
+	// once per frame: finish the variants whose compile has completed, or without
+	// parallel compiles block on at most FINISHES_PER_UPDATE of them
+	void Update();
+	bool IsComplete() const { return pending.empty(); }
+
+	// the variant to draw 'features' with, its fallback until that one is ready
+	const Program& Get(unsigned features) const;
+	// SHADER_STANDARD, with the G-buffer and instanced bits of 'features'
+	static unsigned Fallback(unsigned features);
+
+	// drops bits that cannot matter: an unlit variant has no lights of any kind or highlights,
+	// and a G-buffer variant leaves all lighting to the deferred pass
+	static unsigned Normalize(unsigned features);
+	// cheapest variant giving the same pixels for a material of this colour; an all-zero
+	// colour zeroes every term, so it needs neither lighting nor a texture
+	static unsigned Cheapest(unsigned features, const float color[4]);
+
+	// build a single program outside the variant set, blocking until it is linked;
+	// the sources see the #defines of 'features' like the variants do
+	static bool BuildProgram(const char* vertexSource, const char* fragmentSource, bool useCache, Program &program, unsigned features = 0);
+
+	std::vector<Program> programs;
+
+private:
+
+	static const int FINISHES_PER_UPDATE = 2;
+
+	// A variant still compiling
+	struct Pending
+	{
+		size_t program;
+		std::string key;
+		GLuint vertex;
+		GLuint fragment;
+	};
+
+	bool Finish(const Pending &build);
+
+	int index[SHADER_VARIANT_COUNT] = {};
+	std::vector<Pending> pending;
+	bool useCache = false;
+	bool async = false;
+};
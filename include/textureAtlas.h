@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureAtlas.h
+// ========
+// pack small textures into shared atlas pages (MaxRects) and keep the layout
+// cached on disk next to the compressed texture cache
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "textureCache.h"
+
+class WorkerPool;
+
+class TextureAtlas
+{
+
+public:
+
+	// An image to consider for the atlas
+	struct Source
+	{
+		std::string file;
+		bool flip;
+	};
+
+	// Where a packed image ended up; the padding around it repeats its edge texels
+	struct Entry
+	{
+		std::string file;
+		bool flip;
+		int page;
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	int pageSize = 2048;
+	int padding = 8;
+	std::vector<Entry> entries;
+	int pageCount = 0;
+
+public:
+	void Build(const std::vector<Source> &sources, int pageSize, int maxEntrySize, int padding);
+
+	int Find(const std::string &file, bool flip) const;
+	void UVTransform(int entry, float transform[4]) const;
+	int MaxLevel() const;
+
+	bool LoadPage(int page, TextureData &data, WorkerPool* workers, bool useCache) const;
+
+private:
+	bool LoadLayout(const std::vector<Entry> &wanted);
+	void SaveLayout() const;
+	void Pack(std::vector<Entry> &wanted);
+	std::string PagePath(int page) const;
+};
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureCache.h
+// ========
+// on-disk cache of block-compressed textures with their full mip chain,
+// stored as DDS files under texture_cache/
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "mappedFile.h"
+#include "mipGenerator.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+class WorkerPool;
+
+enum class TextureFormat
+{
+	RGB8,
+	RGBA8,
+	BC1,
+	BC3
+};
+
+// CPU copy of a texture: every mip level packed back to back, either in 'bytes'
+// or, for cache entries, read in place from the mapped file
+struct TextureData
+{
+	struct Level
+	{
+		int width;
+		int height;
+		size_t offset;
+		size_t size;
+	};
+
+	TextureFormat format = TextureFormat::RGB8;
+	int width = 0;
+	int height = 0;
+	int maxDimension = 0;					// budget the source was scaled down to, 0 for none
+	std::vector<Level> levels;
+	std::vector<unsigned char> bytes;		// owned levels, empty when 'mapping' is set
+	std::shared_ptr<MappedFile> mapping;	// file the levels are read from in place
+	size_t mappingOffset = 0;				// where the first level starts in the mapping
+
+	const unsigned char* Bytes() const { return mapping ? mapping->Data() + mappingOffset : bytes.data(); }
+	size_t ByteCount() const { return mapping ? mapping->Size() - mappingOffset : bytes.size(); }
+
+	bool IsCompressed() const { return format == TextureFormat::BC1 || format == TextureFormat::BC3; }
+};
+
+namespace TextureCache
+{
+	// result of re-encoding a source image and checking it against its cache entry
+	struct VerifyReport
+	{
+		bool sourceLoaded = false;
+		bool cacheFound = false;
+		bool matchesCache = false;
+		double psnr = 0.0;
+		int levels = 0;
+		size_t sourceBytes = 0;
+		size_t compressedBytes = 0;
+	};
+
+	std::string EntryPath(const std::string &file, bool flip);
+
+	// true when 'entry' exists and was written after 'source' last changed
+	bool IsFresh(const std::string &entry, const std::string &source);
+
+	// decode a source image to 3 or 4 channels straight from its mapped file; free with stbi_image_free()
+	unsigned char* DecodeSource(const std::string &file, bool flip, int &width, int &height, int &channels);
+
+	// longest side a texture may keep when loaded, 0 for no limit; a file's own limit overrides the global one
+	void SetMaxDimension(int maxDimension);
+	void SetMaxDimension(const std::string &file, int maxDimension);
+	int MaxDimension(const std::string &file);
+
+	// scale decoded pixels into 'scaled' when they exceed the file's limit;
+	// returns false, leaving the size alone, when they already fit
+	bool FitToBudget(const std::string &file, const unsigned char* pixels, int &width, int &height, int channels,
+		std::vector<unsigned char> &scaled, WorkerPool* workers);
+
+	void Build(const unsigned char* pixels, int width, int height, int channels, TextureData &data, WorkerPool* workers);
+	void FromPixels(const unsigned char* pixels, int width, int height, int channels, TextureData &data, WorkerPool* workers);
+	void SetMipFilter(MipFilter filter);
+	bool Load(const std::string &file, bool flip, TextureData &data);
+	bool Save(const std::string &file, bool flip, const TextureData &data);
+
+	bool ReadDDS(const std::string &path, TextureData &data);
+	bool WriteDDS(const std::string &path, const TextureData &data);
+
+	VerifyReport Verify(const std::string &file, bool flip, WorkerPool* workers);
+}
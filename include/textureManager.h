@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureManager.h
+// ========
+// owns every scene texture behind a handle, keeps the full-resolution ones
+// within a memory budget and drops the least recently used back to their
+// low-resolution mip tail
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "textureStreamer.h"
+
+#include <string>
+#include <vector>
+
+class TextureAtlas;
+
+typedef int TextureHandle;
+const TextureHandle INVALID_TEXTURE = -1;
+
+class TextureManager
+{
+
+public:
+
+	// Residency of one texture
+	enum class State
+	{
+		Unloaded,	// nothing on the GPU yet
+		Loading,	// requested from the streamer, 'full' may hold its coarse levels
+		Resident,	// full chain on the GPU
+		Evicted,	// only the mip tail on the GPU
+		Failed		// the image could not be loaded; its tail if it has one, else white
+	};
+
+	// Stores what is needed to (re)load a texture and what it currently costs
+	struct Texture
+	{
+		std::string file;			// image file, empty for atlas pages
+		bool flip;
+		const TextureAtlas* atlas;	// atlas the page belongs to, or null
+		int page;
+		State state;
+		GLuint full;				// full chain while resident, or while its levels stream in
+		int fullBaseSize;			// largest side of the finest level of 'full' uploaded so far
+		GLuint tail;				// low-resolution tail, kept after the first load
+		size_t fullBytes;
+		size_t tailBytes;
+		unsigned int lastUsedFrame;
+		float screenSize;			// largest screen coverage this texture was drawn at in lastUsedFrame
+		TextureStreamer::Priority priority;
+	};
+
+public:
+	void Initialize(TextureStreamer* streamer, size_t budgetBytes, int tailSize);
+	void Shutdown();
+
+	TextureHandle Load(const char* file, bool flip);
+	TextureHandle LoadAtlasPage(const TextureAtlas* atlas, int page);
+
+	void Bind(TextureHandle handle, int unit, float screenSize);
+	void Update();
+
+	size_t ResidentBytes() const { return residentBytes; }
+
+private:
+	static const int MAX_UNITS = 32;
+
+	void Request(TextureHandle handle);
+	void Progress(TextureHandle handle, const TextureStreamer::LoadedTexture &loaded);
+	void EvictToBudget();
+
+	TextureStreamer* streamer = nullptr;
+	size_t budget = 0;
+	int tailSize = 0;
+	std::vector<Texture> textures;
+	size_t residentBytes = 0;		// full chains and tails currently on the GPU
+	unsigned int frame = 0;
+	GLuint white = 0;				// drawn while a texture has nothing loaded
+	GLuint bound[MAX_UNITS] = {};	// what Bind() last put on each unit
+	bool overBudgetReported = false;
+};
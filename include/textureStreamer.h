@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureStreamer.h
+// ========
+// decode images on the worker pool and upload them to GL textures through
+// a ring of persistently mapped pixel buffer objects, a few rows per frame
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "textureCache.h"
+#include "workerPool.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class TextureAtlas;
+
+class TextureStreamer
+{
+
+public:
+
+	// Handed to the requester each time a finer level becomes visible
+	struct LoadedTexture
+	{
+		GLuint texture;			// owned by the requester from the first call on
+		GLint baseLevel;		// finest level uploaded so far, 0 once complete
+		int baseSize;			// largest side of that level
+		GLuint tail;			// copy of the levels no larger than the requested tail size, or 0;
+								// only set on the first call
+		size_t bytes;			// size of all levels of 'texture'
+		size_t tailBytes;		// size of all levels of 'tail'
+		bool failed;			// the image could not be loaded: no texture, and no further calls
+	};
+	typedef std::function<void(const LoadedTexture&)> ProgressCallback;
+
+	// Shared with the requester, who raises it for images that cover more of
+	// the screen; the decode and upload queues serve the highest first
+	typedef std::shared_ptr<std::atomic<float>> Priority;
+
+	// Stores an image on its way from the file to its texture
+	struct PendingImage
+	{
+		std::string name;		// file or atlas page, for the log
+		std::function<bool(TextureData&)> load;	// fills 'data', runs on a worker
+		ProgressCallback progress;	// called on the GL thread as levels arrive
+		Priority priority;
+		GLint maxLevel;			// GL_TEXTURE_MAX_LEVEL, -1 for the full chain
+		int tailSize;			// largest side of the levels copied into the tail, 0 for none
+		GLuint texture;			// texture receiving the uploaded rows
+		TextureData data;		// decoded or cached levels, freed after the last row
+		int level;				// level being uploaded, counting down to 0
+		int row;				// next row of that level
+		bool visible;			// the requester has been handed the texture
+		bool failed;			// the loader failed, only the requester is left to tell
+	};
+
+public:
+	void Initialize(size_t uploadBudgetBytes, WorkerPool* workers, bool useCache);
+	void Shutdown();
+
+	void Request(const char* file, bool flip, int tailSize, const Priority &priority, const ProgressCallback &progress);
+	void RequestAtlas(const TextureAtlas* atlas, int page, int tailSize, const Priority &priority, const ProgressCallback &progress);
+	void Update();
+
+	bool IsIdle();
+
+private:
+	// the ring holds one budget-sized segment per frame in flight
+	static const int RING_SEGMENTS = 3;
+
+	void Queue(PendingImage &image);
+	void DecodeNext();
+	bool LoadFile(const std::string &file, bool flip, TextureData &data);
+	bool UploadRows(PendingImage &image, size_t &segmentUsed);
+	void ShowLevel(PendingImage &image);
+	GLuint CreateTail(const PendingImage &image, size_t &tailBytes);
+
+	size_t budget = 0;
+	GLuint pbo = 0;
+	unsigned char* mapped = nullptr;
+	GLsync fences[RING_SEGMENTS] = {};
+	int segment = 0;
+	WorkerPool* workers = nullptr;
+	bool useCache = false;
+
+	JobCounter decoding;				// decode jobs posted and not yet finished
+	std::mutex lock;
+	bool running = false;
+	std::deque<PendingImage> requests;	// waiting for a decode job
+	std::deque<PendingImage> decoded;	// waiting for the GL thread
+	std::deque<PendingImage> uploads;	// owned by the GL thread
+};
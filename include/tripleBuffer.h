@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////
+// tripleBuffer.h
+// ========
+// lock-free hand-off of the newest value from one writer thread to one reader
+// thread; neither side ever waits and the reader never sees a half-written value
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer
+{
+
+public:
+	// writer: fill Back() completely, then Publish() it as the newest value
+	T& Back() { return slots[back]; }
+	void Publish()
+	{
+		back = present.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	// reader: the newest published value, the same one again if nothing newer arrived
+	const T& Latest()
+	{
+		if (present.load(std::memory_order_relaxed) & FRESH)
+			front = present.exchange(front, std::memory_order_acq_rel) & INDEX;
+		return slots[front];
+	}
+
+private:
+	static const unsigned INDEX = 3;
+	static const unsigned FRESH = 4;
+
+	T slots[3] = {};
+	unsigned back = 0;						// writer only
+	unsigned front = 1;						// reader only
+	std::atomic<unsigned> present{ 2 };		// slot between the two, FRESH until read
+};
@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+// workerPool.h
+// ========
+// fixed set of worker threads for splitting CPU-heavy work across cores:
+// jobs with completion counters and dependencies, scheduled by work stealing
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts the unfinished jobs of a group. Jobs posted to run after a counter
+// are held back until it drops to zero.
+class JobCounter
+{
+
+public:
+	bool IsDone() const { return pending == 0; }
+
+private:
+	friend class WorkerPool;
+
+	std::atomic<int> pending{ 0 };
+	std::mutex lock;
+	std::vector<std::function<void()>> waiting;	// queues the held back jobs
+};
+
+class WorkerPool
+{
+
+public:
+	void Start(int threadCount = 0);
+	void Stop();
+
+	void Run(std::function<void()> job, JobCounter* counter = nullptr, JobCounter* after = nullptr);
+	void Wait(JobCounter &counter);
+
+	void ParallelFor(int count, const std::function<void(int)> &body);
+	int ThreadCount() const;
+	// index of the calling worker, or ThreadCount() on any thread outside the pool
+	int CurrentThread() const;
+
+private:
+	struct Job
+	{
+		std::function<void()> work;
+		JobCounter* counter;
+	};
+	// one per worker: the owner pushes and pops at the back, where the work it
+	// just split off is still in cache, and idle workers steal from the front.
+	// A ring that only ever grows, so queuing stops allocating once warm.
+	struct Queue
+	{
+		std::mutex lock;
+		std::vector<Job> jobs;		// ring storage, a power of two long
+		size_t head = 0;			// oldest job
+		size_t count = 0;
+
+		void PushBack(Job job);
+		Job PopBack();
+		Job PopFront();
+	};
+
+	void WorkerLoop(int index);
+	void Push(Job job);
+	bool Pop(int index, Job &job);
+	void Execute(Job &job);
+
+	std::vector<std::thread> threads;
+	std::vector<std::unique_ptr<Queue>> queues;		// one per worker, then one for all other threads
+	std::atomic<int> queued{ 0 };
+	std::atomic<int> sleeping{ 0 };
+	std::atomic<bool> running{ false };
+	std::mutex sleepLock;
+	std::condition_variable wake;
+};
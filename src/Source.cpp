@@ -1,5 +1,10 @@
 #include <iostream>         // cout, cerr
 #include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <chrono>           // benchmark timing
+#include <algorithm>        // max
+#include <cmath>            // tanf
+#include <random>           // scattered point lights
 #include <GL/glew.h>        // GLEW library
 #include <GLFW/glfw3.h>     // GLFW library
 
@@ -9,7 +14,24 @@
 #include <glm/glm/gtc/type_ptr.hpp>
 #include <stb_image/stb_image.h>
 #include <meshes.h>
+#include <allocTracker.h>
+#include <app.h>
 #include <camera.h>
+#include <quaternionCamera.h>
+#include <config.h>
+#include <deferredRenderer.h>
+#include <drawList.h>
+#include <frameArena.h>
+#include <gpuTimer.h>
+#include <lightClusters.h>
+#include <mipGenerator.h>
+#include <shaderLibrary.h>
+#include <textureAtlas.h>
+#include <textureCache.h>
+#include <textureManager.h>
+#include <textureStreamer.h>
+#include <tripleBuffer.h>
+#include <workerPool.h>
 using namespace std; // Standard namespace
 
 //custom colors
@@ -29,18 +51,31 @@ namespace
 	const char* const WINDOW_TITLE = "Making a mesh out of things"; // Macro for window title
 
 	//Globals
-	Camera cam;
+	QuaternionCamera cam;
 	bool firstMouse = true;
-	float lastX = 800.0f / 2.0;
-	float lastY = 600.0 / 2.0;
+	double lastX = 800.0f / 2.0;
+	double lastY = 600.0 / 2.0;
+	// cursor movement since the camera last turned, applied once per batch of events
+	double gMouseDeltaX = 0.0;
+	double gMouseDeltaY = 0.0;
 	float cam_x = -91.0f;
 	float cam_y = -7.0f;
 	float cam_z = -1.0f;
+	// distance scale per 1/60 s of movement, what it used to move per frame at 60 fps
 	float cam_speed = 0.01f;
+	const float CAM_SPEED_RATE = 60.0f;
+	// camera position at the previous fixed step, drawn frames lie in between
+	glm::vec3 gPreviousCamPos;
+	// the camera moved during the last step, so one more frame is owed once it stops
+	bool gCamMoving = false;
 	float rotateCamX = 0.0f;
 	float rotateCamY = 0.0f;
 	float sensitivity = 0.05f;
 	bool ortho = false;
+	// shade through the G-buffer instead of per draw, toggled with G and F
+	bool deferred = false;
+	// lay down depth before shading, toggled with Z and X
+	bool depthPrepass = false;
 
 	// Variables for window width and height
 	const int WINDOW_WIDTH = 800;
@@ -54,15 +89,123 @@ namespace
 		GLuint nIndices;    // Number of indices of the mesh
 	};
 
+	// Window and fixed-step main loop
+	app gApp(WINDOW_TITLE, WINDOW_WIDTH, WINDOW_HEIGHT);
 	// Main GLFW window
 	GLFWwindow* gWindow = nullptr;
+	// Framebuffer size as the window reports it, input thread only
+	int gFramebufferWidth = WINDOW_WIDTH;
+	int gFramebufferHeight = WINDOW_HEIGHT;
+
+	// What the simulation hands the renderer after each step: all URender may
+	// know of the camera, the mode keys and the window, so input and drawing
+	// can run on different threads
+	struct FrameState
+	{
+		glm::vec3 previousPosition;		// camera at the step before
+		glm::vec3 position;
+		glm::quat orientation;
+		double time;					// when the step ended, in app seconds
+		bool ortho;
+		bool deferred;
+		bool depthPrepass;
+		int width, height;				// framebuffer
+	};
+	TripleBuffer<FrameState> gFrames;
+	// Frame being drawn, camera already interpolated, the camera drawn from with its
+	// cached matrices, and the framebuffer size the viewport and G-buffer were last
+	// set up for; render thread only
+	FrameState gFrame;
+	QuaternionCamera gView;
+	int gViewportWidth = 0;
+	int gViewportHeight = 0;
 	// Triangle mesh data
 	//GLMesh gMesh;
-	// Shader program
-	GLuint gProgramId;
+	// Point lights sorted into view-frustum clusters each frame
+	LightClusters gLightClusters;
+	// G-buffer and lighting pass of the deferred path, unused while drawing forward
+	DeferredRenderer gDeferredRenderer;
+	bool gDeferredAvailable = false;
+	// GPU time of each path, reported every REPORT_FRAMES frames when render.timings is on
+	GpuTimer gForwardTimer;
+	GpuTimer gGeometryTimer;
+	GpuTimer gLightingTimer;
+	// fragments the colour pass shades, against the pixels on screen
+	GpuTimer gOverdrawCounter;
+	bool gReportTimes = false;
+	int gReportFrame = 0;
+	const int REPORT_FRAMES = 120;
+	// Depth-only programs of the prepass, for single and instanced draws,
+	// and whether UDrawScene is running them
+	ShaderLibrary::Program gDepthProgram;
+	ShaderLibrary::Program gDepthInstancedProgram;
+	bool gDepthPass = false;
+	// Shader variants, and the one the last draw used
+	ShaderLibrary gShaders;
+	const ShaderLibrary::Program* gProgram = nullptr;
+	// texture slot whose uvTransform gProgram currently holds
+	int gProgramSlot = -1;
+	// restore linked programs from shader_cache/ instead of compiling them
+	bool gShaderCacheEnabled = true;
 
 	//Shape Meshes from Professor Brian
 	Meshes meshes;
+
+	// Settings read from engine.cfg
+	Config gConfig;
+	// Threads shared by CPU-heavy work such as texture compression
+	WorkerPool gWorkers;
+	// Background texture decoding and PBO uploads
+	TextureStreamer gTextures;
+	// Handles, residency budget and eviction of every scene texture
+	TextureManager gTextureManager;
+	// Scattered objects beyond the desk, culled and recorded on the workers each frame
+	DrawList gDrawList;
+	// Transient data of the last two frames, one arena per worker and one for the render thread
+	FrameArena gFrameArena;
+	// Heap allocations per frame, built with TRACK_ALLOCATIONS: reported every
+	// gAllocReportFrames frames, and frames past the warm-up allocating more
+	// than gAllocBudget times fail the run
+	int gAllocReportFrames = 0;
+	int gAllocReportFrame = 0;
+	int gAllocWarmup = 300;
+	int gAllocBudget = -1;
+	int gAllocFramesDrawn = 0;
+	int gAllocFramesOver = 0;
+
+	// Scene textures; the index is the texture unit each one is bound to.
+	// Every image but the first is flipped vertically on load.
+	struct SceneTexture
+	{
+		const char* file;
+		bool flip;
+	};
+	const SceneTexture SCENE_TEXTURES[] = {
+		{ "old-concrete-texture-with-blue-paint.JPG", false },
+		{ "pen_holder.JPG", true },
+		{ "gray-smooth-textured-background.JPG", true },
+		{ "gray-lined-paper-texture.JPG", true },
+		{ "wooden-flooring-textured-background-design.JPG", true },
+		{ "buttons.JPG", true },
+		{ "wave1.jpg", true },
+		{ "back_of_mac.JPG", true },
+		{ "mac_os.JPG", true },
+		{ "multi-colored-psychedelic-background.JPG", true },
+	};
+	const int SCENE_TEXTURE_COUNT = sizeof(SCENE_TEXTURES) / sizeof(SCENE_TEXTURES[0]);
+
+	// Small scene textures packed together
+	TextureAtlas gAtlas;
+	// Where each scene texture is sampled from: its own texture with an identity
+	// transform, or an atlas page with the scale.xy/offset.zw of its rectangle
+	struct TextureSlot
+	{
+		TextureHandle texture;
+		float uvTransform[4];
+	};
+	TextureSlot gTextureSlots[SCENE_TEXTURE_COUNT];
+	// last slot bound this frame, so repeats cost nothing
+	int gBoundSlot = -1;
 }
 
 /* User-defined Function prototypes to:
@@ -70,17 +213,34 @@ namespace
  * redraw graphics on the window when resized,
  * and render graphics on the screen
  */
-bool UInitialize(int, char*[], GLFWwindow** window);
 void UResizeWindow(GLFWwindow* window, int width, int height);
-void UProcessInput(GLFWwindow* window);
+void UProcessInput(GLFWwindow* window, double timestep);
 void mouseInput(GLFWwindow* window, int button, int action, int mods);
 void mouseScrollInput(GLFWwindow* window, double xoffset, double yoffset);
 void mouse_click(GLFWwindow* window, int button, int action, int mods);
 void cursorPos(GLFWwindow* window, double xPos, double yPos);
-void URender();
-bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, GLuint &programId);
-void UDestroyShaderProgram(GLuint programId);
-void loadImg(const char* file, int memoryLoc);
+void UApplyMouseLook();
+void UPublishFrame();
+void URender(double time);
+void UDrawScene();
+void UDrawObjects();
+bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, ShaderLibrary &shaders);
+void UDestroyShaderProgram(ShaderLibrary &shaders);
+TextureHandle loadImg(const char* file, bool flip);
+void ULoadSceneTextures();
+void UCreatePointLights(int count, float radius);
+void UCreateSceneObjects(int count);
+void UReportRenderTimes();
+void UReportAllocations();
+void UBuildAtlas();
+void UBindTexture(int slot, const glm::mat4 &model);
+unsigned UPassFeatures(unsigned features);
+void USetMaterial(unsigned features, const glm::vec4 &color, const glm::mat4 &model);
+float UScreenSize(const glm::mat4 &model);
+int UTextureCacheTool(bool verifyOnly);
+int UMipmapBenchmark();
+int UMeshBenchmark();
+int UAllocationCheck();
 ////////////////////////////////////////////////////////////////////////////////////////
 // SHADER CODE
 /* Vertex Shader Source Code*/
@@ -92,15 +252,31 @@ out vec4 vertexColor; // variable to transfer color data to the fragment shader
 out vec2 texCoords;
 out vec3 normals;
 out vec3 curPos;
+flat out vec4 instanceColor; // INSTANCED variants only
 //Global variables for the  transform matrices
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+// INSTANCED variants draw DrawList objects, starting at objectBase
+struct ObjectData { mat4 model; vec4 color; };
+layout(std430, binding = 3) readonly buffer Objects { ObjectData objects[]; };
+uniform uint objectBase;
+invariant gl_Position;
 
 void main()
 {
-	curPos = vec3(model * vec4(position, 1.0f));
-	normals = mat3(transpose(inverse(model))) * color;
+	mat4 world = model;
+	instanceColor = vec4(1.0f);
+	if (INSTANCED != 0)
+	{
+		world = objects[objectBase + uint(gl_InstanceID)].model;
+		instanceColor = objects[objectBase + uint(gl_InstanceID)].color;
+	}
+	curPos = vec3(world * vec4(position, 1.0f));
+	normals = color;
+	// must not differ from the depth prepass by a bit, or GL_EQUAL would reject the fragment
+	if (LIT != 0)
+		normals = mat3(transpose(inverse(world))) * color;
 	gl_Position = projection * view * vec4(curPos, 1.0f); // transforms vertices to clip coordinates
 	vertexColor = vec4(color,1.0f); // references incoming color data
 	texCoords = texCoord;
@@ -109,44 +285,209 @@ void main()
 
 
 /* Fragment Shader Source Code*/
+// LIT, TEXTURED, SPECULAR, LIGHT_COUNT, CLUSTERED, GBUFFER and INSTANCED are #defined per variant by ShaderLibrary
 const GLchar * fragmentShaderSource = GLSL(440,
 	in vec4 vertexColor; // Variable to hold incoming color data from vertex shader
 in vec2 texCoords;
 in vec3 curPos;
 in vec3 normals;
-out vec4 fragmentColor;
-out  vec4 fragmentTexture;
+flat in vec4 instanceColor;
+layout(location = 0) out vec4 fragmentTexture;
+layout(location = 1) out vec4 fragmentNormal; // G-buffer variants only
 //out  vec4 lightBulb;
 
 uniform vec4 objectColor;
 uniform vec3 lightBulbPos;
 uniform vec3 lightScreenPos;
 uniform sampler2D myTexture;
+uniform vec4 uvTransform; // scale.xy and offset.zw of the texture inside its atlas page
 uniform vec4 lightBulbColor;
 uniform vec4 lightScreenColor;
 uniform vec3 viewDirection;
+uniform mat4 view;
+uniform vec4 clusterScale; // tiles per pixel in xy, slices per log depth in z, near plane in w
+uniform ivec3 clusterGrid;
+layout(std430, binding = 0) readonly buffer PointLights { vec4 pointLights[]; }; // position and radius, then color
+layout(std430, binding = 1) readonly buffer LightGrid { uvec2 lightGrid[]; }; // offset and count per cluster
+layout(std430, binding = 2) readonly buffer LightIndices { uint lightIndices[]; };
 void main()
 {
 	//fragmentColor = vec4(vertexColor);
 	//fragmentColor = vec4(objectColor);
-	vec3 normal = normalize(normals);
-	vec3 lightBulbDir = normalize(lightBulbPos - curPos);
-	vec3 lightScreenDir = normalize(lightScreenPos - curPos);
+	fragmentTexture = INSTANCED != 0 ? instanceColor : objectColor;
+	if (TEXTURED != 0)
+	{
+		// atlas rectangles cannot wrap, so their coordinates are clamped to the rectangle
+		vec2 uv = uvTransform.xy == vec2(1.0f) ? texCoords : uvTransform.xy * clamp(texCoords, 0.0f, 1.0f) + uvTransform.zw;
+		fragmentTexture *= texture(myTexture, uv);
+	}
+	if (GBUFFER != 0)
+	{
+		// the deferred lighting pass shades this pixel later with the terms the material
+		// asks for: 0 unlit, else 1 plus 2 for the screen light and 4 for specular
+		float material = LIT != 0 ? 1.0f + (LIGHT_COUNT > 1 ? 2.0f : 0.0f) + (SPECULAR != 0 ? 4.0f : 0.0f) : 0.0f;
+		fragmentNormal = vec4(normalize(normals), material);
+		return;
+	}
+	if (LIT != 0)
+	{
+		// the bulb's diffuse term is tinted by the screen's colour and the other way round
+		vec3 normal = normalize(normals);
+		float ambientBrightness = 0.1f;
+		vec3 lightBulbDir = normalize(lightBulbPos - curPos);
+		float difForBulb = max(dot(normal, lightBulbDir), 0.0f);
+		vec4 lighting = (ambientBrightness * lightBulbColor) + (difForBulb * lightScreenColor);
+		if (LIGHT_COUNT > 1)
+		{
+			vec3 lightScreenDir = normalize(lightScreenPos - curPos);
+			float difForScreen = max(dot(normal, lightScreenDir), 0.0f);
+			lighting += (ambientBrightness * lightScreenColor) + (difForScreen * lightBulbColor);
+		}
+		if (SPECULAR != 0)
+		{
+			float specularLighting = 2.0f;
+			vec3 viewDir = normalize(viewDirection - curPos);
+			vec3 reflectDirLightBulb = reflect(-lightBulbDir, normal);
+			float specLightBulb = pow(max(dot(viewDir, reflectDirLightBulb), 0.0f), 32);
+			lighting += (specularLighting * specLightBulb * lightBulbColor);
+		}
+		if (CLUSTERED != 0)
+		{
+			// only the point lights whose sphere reaches this fragment's froxel
+			float depth = -(view * vec4(curPos, 1.0f)).z;
+			ivec3 cell = ivec3(vec3(gl_FragCoord.xy * clusterScale.xy, log(max(depth, clusterScale.w) / clusterScale.w) * clusterScale.z));
+			cell = min(cell, clusterGrid - 1);
+			uvec2 range = lightGrid[(cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x];
+			for (uint i = 0u; i < range.y; i++)
+			{
+				uint light = lightIndices[range.x + i];
+				vec4 positionRadius = pointLights[2u * light];
+				vec3 toLight = positionRadius.xyz - curPos;
+				float falloff = clamp(1.0f - dot(toLight, toLight) / (positionRadius.w * positionRadius.w), 0.0f, 1.0f);
+				lighting += pointLights[2u * light + 1u] * (falloff * falloff * max(dot(normal, normalize(toLight)), 0.0f));
+			}
+		}
+		fragmentTexture *= lighting;
+	}
+	
+}
+);
+
+
+/* Depth Prepass Vertex Shader Source Code*/
+// the same position math as the scene vertex shader, so both passes produce identical depth
+const GLchar * depthVertexShaderSource = GLSL(440,
+layout(location = 0) in vec3 position;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+struct ObjectData { mat4 model; vec4 color; };
+layout(std430, binding = 3) readonly buffer Objects { ObjectData objects[]; };
+uniform uint objectBase;
+invariant gl_Position;
+void main()
+{
+	mat4 world = model;
+	if (INSTANCED != 0)
+		world = objects[objectBase + uint(gl_InstanceID)].model;
+	vec3 curPos = vec3(world * vec4(position, 1.0f));
+	gl_Position = projection * view * vec4(curPos, 1.0f);
+}
+);
+
+
+/* Depth Prepass Fragment Shader Source Code*/
+const GLchar * depthFragmentShaderSource = GLSL(440,
+void main()
+{
+}
+);
+
+
+/* Deferred Lighting Pass Vertex Shader Source Code*/
+const GLchar * lightingVertexShaderSource = GLSL(440,
+out vec2 screenUV;
+void main()
+{
+	// one triangle over the whole screen, corners at (-1,-1), (3,-1) and (-1,3)
+	vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	screenUV = corner;
+	gl_Position = vec4(corner * 2.0f - 1.0f, 0.0f, 1.0f);
+}
+);
+
+
+/* Deferred Lighting Pass Fragment Shader Source Code*/
+// the same lights as the forward variant of each pixel's material, applied once per pixel
+const GLchar * lightingFragmentShaderSource = GLSL(440,
+in vec2 screenUV;
+layout(location = 0) out vec4 fragmentTexture;
+
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+uniform mat4 inverseViewProjection;
+uniform mat4 view;
+uniform vec3 lightBulbPos;
+uniform vec3 lightScreenPos;
+uniform vec4 lightBulbColor;
+uniform vec4 lightScreenColor;
+uniform vec3 viewDirection;
+uniform vec4 clusterScale;
+uniform ivec3 clusterGrid;
+layout(std430, binding = 0) readonly buffer PointLights { vec4 pointLights[]; };
+layout(std430, binding = 1) readonly buffer LightGrid { uvec2 lightGrid[]; };
+layout(std430, binding = 2) readonly buffer LightIndices { uint lightIndices[]; };
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depthSample = texelFetch(gDepth, pixel, 0).r;
+	if (depthSample == 1.0f)
+		discard;
+	vec4 albedo = texelFetch(gAlbedo, pixel, 0);
+	vec4 normalMaterial = texelFetch(gNormal, pixel, 0);
+	int material = int(normalMaterial.w + 0.5f);
+	if (material == 0)
+	{
+		fragmentTexture = albedo;
+		return;
+	}
+
+	vec4 world = inverseViewProjection * vec4(vec3(screenUV, depthSample) * 2.0f - 1.0f, 1.0f);
+	vec3 curPos = world.xyz / world.w;
+	vec3 normal = normalize(normalMaterial.xyz);
 	float ambientBrightness = 0.1f;
-	vec4 ambientLighting = (ambientBrightness * lightBulbColor)+(ambientBrightness * lightScreenColor);
+	vec3 lightBulbDir = normalize(lightBulbPos - curPos);
 	float difForBulb = max(dot(normal, lightBulbDir), 0.0f);
-	float difForScreen = max(dot(normal, lightScreenDir), 0.0f);
-	vec4 diffuse = (difForBulb*lightScreenColor)+(difForScreen * lightBulbColor);
-	float specularLighting = 2.0f;
-	vec3 viewDir = normalize(viewDirection - curPos);
-	vec3 reflectDirLightBulb = reflect(-lightBulbDir, normal);
-	vec3 reflectDirScreen = reflect(-lightScreenDir, normal);
-	float specLightBulb = pow(max(dot(viewDir, reflectDirLightBulb), 0.0f), 32);
-	float specScreen = pow(max(dot(viewDir, reflectDirScreen), 0.0f), 32);
-	vec4 specular = (specularLighting * specLightBulb * lightBulbColor);
-
-	fragmentTexture = texture(myTexture, texCoords) * objectColor * (ambientLighting+diffuse+specular);
-	
+	vec4 lighting = (ambientBrightness * lightBulbColor) + (difForBulb * lightScreenColor);
+	if ((material & 2) != 0)
+	{
+		vec3 lightScreenDir = normalize(lightScreenPos - curPos);
+		float difForScreen = max(dot(normal, lightScreenDir), 0.0f);
+		lighting += (ambientBrightness * lightScreenColor) + (difForScreen * lightBulbColor);
+	}
+	if ((material & 4) != 0)
+	{
+		float specularLighting = 2.0f;
+		vec3 viewDir = normalize(viewDirection - curPos);
+		vec3 reflectDirLightBulb = reflect(-lightBulbDir, normal);
+		float specLightBulb = pow(max(dot(viewDir, reflectDirLightBulb), 0.0f), 32);
+		lighting += (specularLighting * specLightBulb * lightBulbColor);
+	}
+
+	float depth = -(view * vec4(curPos, 1.0f)).z;
+	ivec3 cell = ivec3(vec3(gl_FragCoord.xy * clusterScale.xy, log(max(depth, clusterScale.w) / clusterScale.w) * clusterScale.z));
+	cell = min(cell, clusterGrid - 1);
+	uvec2 range = lightGrid[(cell.z * clusterGrid.y + cell.y) * clusterGrid.x + cell.x];
+	for (uint i = 0u; i < range.y; i++)
+	{
+		uint light = lightIndices[range.x + i];
+		vec4 positionRadius = pointLights[2u * light];
+		vec3 toLight = positionRadius.xyz - curPos;
+		float falloff = clamp(1.0f - dot(toLight, toLight) / (positionRadius.w * positionRadius.w), 0.0f, 1.0f);
+		lighting += pointLights[2u * light + 1u] * (falloff * falloff * max(dot(normal, normalize(toLight)), 0.0f));
+	}
+	fragmentTexture = albedo * lighting;
 }
 );
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -154,117 +495,207 @@ void main()
 
 int main(int argc, char* argv[])
 {
-	if (!UInitialize(argc, argv, &gWindow))
+	gConfig.Load("engine.cfg");
+	gWorkers.Start(gConfig.GetInt("workers.threads", 0));
+	TextureCache::SetMipFilter(gConfig.GetString("texture.mipFilter", "kaiser") == "box" ? MipFilter::Box : MipFilter::Kaiser);
+	TextureCache::SetMaxDimension(gConfig.GetInt("texture.maxDimension", 1024));
+	for (const SceneTexture &texture : SCENE_TEXTURES)
+	{
+		int maxDimension = gConfig.GetInt(std::string("texture.maxDimension.") + texture.file, -1);
+		if (maxDimension >= 0)
+			TextureCache::SetMaxDimension(texture.file, maxDimension);
+	}
+
+	// offline texture cache tools, these run without a window or GPU
+	if (argc > 1 && strcmp(argv[1], "--build-texture-cache") == 0)
+		return UTextureCacheTool(false);
+	if (argc > 1 && strcmp(argv[1], "--verify-texture-cache") == 0)
+		return UTextureCacheTool(true);
+	if (argc > 1 && strcmp(argv[1], "--bench-mipmaps") == 0)
+		return UMipmapBenchmark();
+	if (argc > 1 && strcmp(argv[1], "--bench-meshes") == 0)
+		return UMeshBenchmark();
+	if (argc > 1 && strcmp(argv[1], "--check-allocations") == 0)
+		return UAllocationCheck();
+
+	if (!gApp.open())
 		return EXIT_FAILURE;
+	gWindow = gApp.window;
+
+	// input callbacks and cursor capture, set up once for the life of the window
+	glfwSetFramebufferSizeCallback(gWindow, UResizeWindow);
+	glfwSetScrollCallback(gWindow, mouseScrollInput);
+	glfwSetMouseButtonCallback(gWindow, mouse_click);
+	glfwSetCursorPosCallback(gWindow, cursorPos);
+	glfwSetInputMode(gWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	// unaccelerated device motion for mouse look, where the platform has it
+	if (glfwRawMouseMotionSupported())
+		glfwSetInputMode(gWindow, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+
+	// cap the bytes copied into textures each frame so new textures never stall a frame
+	gTextures.Initialize((size_t)(gConfig.GetFloat("texture.uploadBudgetMB", 4.0f) * 1024 * 1024),
+		&gWorkers, gConfig.GetBool("texture.cache", true));
+	// full-resolution textures beyond the budget fall back to their mip tail
+	gTextureManager.Initialize(&gTextures, (size_t)(gConfig.GetFloat("texture.budgetMB", 512.0f) * 1024 * 1024),
+		gConfig.GetInt("texture.tailSize", 64));
 
 	// Create the mesh
 	//UCreateMesh(gMesh); // Calls the function to create the Vertex Buffer Object
-	meshes.CreateMeshes();
+	// only the primitives the scene draws, generated on the workers and uploaded together
+	meshes.useCache = gConfig.GetBool("mesh.cache", true);
+	meshes.CreateMeshes({ MeshPrimitive::Plane, MeshPrimitive::Box, MeshPrimitive::Cone, MeshPrimitive::Cylinder, MeshPrimitive::Sphere, MeshPrimitive::Torus }, &gWorkers);
 
 	//load textures
-	loadImg("old-concrete-texture-with-blue-paint.JPG", 0);
-	loadImg("pen_holder.JPG", 1);
-	loadImg("gray-smooth-textured-background.JPG", 2);
-	loadImg("gray-lined-paper-texture.JPG", 3);
-	loadImg("wooden-flooring-textured-background-design.JPG", 4);
-	loadImg("buttons.JPG", 5);
-	loadImg("wave1.jpg", 6);
-	loadImg("back_of_mac.JPG", 7);
-	loadImg("mac_os.JPG", 8);
-	loadImg("multi-colored-psychedelic-background.JPG", 9);
+	ULoadSceneTextures();
 	// Create the shader program
-	if (!UCreateShaderProgram(vertexShaderSource, fragmentShaderSource, gProgramId))
+	gShaderCacheEnabled = gConfig.GetBool("shader.cache", true);
+	if (!UCreateShaderProgram(vertexShaderSource, fragmentShaderSource, gShaders))
 		return EXIT_FAILURE;
 
+	// optional deferred path; without it the forward path is all there is
+	int framebufferWidth, framebufferHeight;
+	glfwGetFramebufferSize(gWindow, &framebufferWidth, &framebufferHeight);
+	gFramebufferWidth = gViewportWidth = framebufferWidth;
+	gFramebufferHeight = gViewportHeight = framebufferHeight;
+	gDeferredAvailable = gDeferredRenderer.Initialize(framebufferWidth, framebufferHeight,
+		lightingVertexShaderSource, lightingFragmentShaderSource, gShaderCacheEnabled);
+	if (!gDeferredAvailable)
+		cout << "Deferred shading unavailable, drawing forward only" << endl;
+	deferred = gDeferredAvailable && gConfig.GetBool("render.deferred", false);
+	gReportTimes = gConfig.GetBool("render.timings", false);
+	gForwardTimer.Initialize();
+	gGeometryTimer.Initialize();
+	gLightingTimer.Initialize();
+	gOverdrawCounter.Initialize(GL_SAMPLES_PASSED);
+
+	// depth-only prepass, so either path shades each pixel once
+	if (!ShaderLibrary::BuildProgram(depthVertexShaderSource, depthFragmentShaderSource, gShaderCacheEnabled, gDepthProgram) ||
+		!ShaderLibrary::BuildProgram(depthVertexShaderSource, depthFragmentShaderSource, gShaderCacheEnabled, gDepthInstancedProgram, SHADER_INSTANCED))
+		return EXIT_FAILURE;
+	depthPrepass = gConfig.GetBool("render.depthPrepass", false);
+
+	// per-frame scratch: culling, sorting and draw building allocate from here, not the heap
+	gFrameArena.Initialize(&gWorkers, (size_t)gConfig.GetInt("memory.frameArenaKB", 256) * 1024);
+	gAllocReportFrames = gConfig.GetInt("memory.allocationReport", 0);
+	gAllocWarmup = gConfig.GetInt("memory.allocationWarmup", 300);
+	gAllocBudget = gConfig.GetInt("memory.allocationBudget", -1);
+	if (!AllocTracker::Enabled() && (gAllocReportFrames > 0 || gAllocBudget >= 0))
+		cout << "Allocation counts need a build with TRACK_ALLOCATIONS defined" << endl;
+
+	// extra point lights on top of the bulb and the screen, culled per cluster
+	gLightClusters.Initialize();
+	UCreatePointLights(gConfig.GetInt("lights.count", 0), gConfig.GetFloat("lights.radius", 6.0f));
+
+	// optional crowd of spinning objects, drawn instanced from the draw list
+	gDrawList.meshes = {
+		{ meshes.Get(MeshPrimitive::Box).vao, (GLsizei)meshes.Get(MeshPrimitive::Box).nIndices, true, meshes.Get(MeshPrimitive::Box).radius },
+		{ meshes.Get(MeshPrimitive::Sphere).vao, (GLsizei)meshes.Get(MeshPrimitive::Sphere).nIndices, true, meshes.Get(MeshPrimitive::Sphere).radius },
+		{ meshes.Get(MeshPrimitive::Torus).vao, (GLsizei)meshes.Get(MeshPrimitive::Torus).nVertices, false, meshes.Get(MeshPrimitive::Torus).radius },
+	};
+	UCreateSceneObjects(gConfig.GetInt("scene.objects", 0));
+	gDrawList.Initialize(gDrawList.objects.size());
+
 	// Sets the background color of the window to black (it will be implicitely used by glClear)
 	glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
 	// render loop
 	// -----------
-	while (!glfwWindowShouldClose(gWindow))
+	// input moves the camera in fixed steps, frames are drawn as often as the
+	// limiter and vsync allow, optionally on a render thread of their own
+	gApp.timestep = 1.0 / std::max(gConfig.GetFloat("frame.simulationRate", 120.0f), 1.0f);
+	gApp.frameLimit = gConfig.GetFloat("frame.limit", 0.0f);
+	gApp.vsync = gConfig.GetBool("frame.vsync", true);
+	gApp.onDemand = gConfig.GetBool("frame.onDemand", false);
+	gApp.idleTimeout = gConfig.GetFloat("frame.idleTimeout", 0.25f);
+	gApp.renderThread = gConfig.GetBool("frame.renderThread", false);
+	gPreviousCamPos = cam.Position();
+	UPublishFrame();
+	gApp.input = UApplyMouseLook;
+	gApp.update = [](double timestep)
+	{
+		UProcessInput(gWindow, timestep);
+		UPublishFrame();
+	};
+	gApp.render = [](double time)
 	{
-		// input
-		// -----
-		UProcessInput(gWindow);
+		// evict textures over budget, then upload whatever the decode jobs have finished
+		gTextureManager.Update();
+		gTextures.Update();
+		// swap in shader variants the driver has finished compiling in the background
+		gShaders.Update();
 
-		glfwPollEvents();
-	}
+		URender(time);
+
+		// keep drawing while textures stream in, shader variants compile and objects spin
+		if (!gTextures.IsIdle() || !gShaders.IsComplete() || !gDrawList.objects.empty())
+			gApp.invalidate();
+	};
+	gApp.run();
 
 	// Release mesh data
 	//UDestroyMesh(gMesh);
 	meshes.DestroyMeshes();
 
-	// Release shader program
-	UDestroyShaderProgram(gProgramId);
-
-	exit(EXIT_SUCCESS); // Terminates the program successfully
-}
-
-
-// Initialize GLFW, GLEW, and create a window
-bool UInitialize(int argc, char* argv[], GLFWwindow** window)
-{
-	// GLFW: initialize and configure
-	// ------------------------------
-	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-	// GLFW: window creation
-	// ---------------------
-	*window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE, NULL, NULL);
-	if (*window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return false;
-	}
-	glfwMakeContextCurrent(*window);
-	glfwSetFramebufferSizeCallback(*window, UResizeWindow);
-	
-	// GLEW: initialize
-	// ----------------
-	// Note: if using GLEW version 1.13 or earlier
-	glewExperimental = GL_TRUE;
-	GLenum GlewInitResult = glewInit();
+	// Release texture uploads still in flight
+	gTextures.Shutdown();
+	gTextureManager.Shutdown();
 
-	if (GLEW_OK != GlewInitResult)
+	// Release shader program
+	UDestroyShaderProgram(gShaders);
+	gLightClusters.Shutdown();
+	gDeferredRenderer.Shutdown();
+	gForwardTimer.Shutdown();
+	gGeometryTimer.Shutdown();
+	gLightingTimer.Shutdown();
+	gOverdrawCounter.Shutdown();
+	gDrawList.Shutdown();
+	glDeleteProgram(gDepthProgram.id);
+	glDeleteProgram(gDepthInstancedProgram.id);
+
+	gWorkers.Stop();
+
+	// perf gate: steady-state frames are expected not to touch the heap
+	if (gAllocFramesOver > 0)
 	{
-		std::cerr << glewGetErrorString(GlewInitResult) << std::endl;
-		return false;
+		cout << gAllocFramesOver << " frames after the warm-up allocated more than " << gAllocBudget << " times" << endl;
+		exit(EXIT_FAILURE);
 	}
 
-	// Displays GPU OpenGL version
-	cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << endl;
-	
-	return true;
+	exit(EXIT_SUCCESS); // Terminates the program successfully
 }
 
 
-// process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
-void UProcessInput(GLFWwindow* window)
+// process all input: query GLFW whether relevant keys are pressed/released this step and react accordingly;
+// runs once per fixed step of timestep seconds, so movement does not depend on the frame rate
+void UProcessInput(GLFWwindow* window, double timestep)
 {   
-	//init URender with globals
-	URender();
-	//void mouseInput(GLFWwindow * window, int button, int action, int mods);
-	glfwSetScrollCallback(window, mouseScrollInput);
-	glfwSetMouseButtonCallback(window, mouse_click);
-	glfwSetCursorPosCallback(window, cursorPos);
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	AllocScope scope(AllocTag::Camera);
+	float move = SPEED * cam_speed * CAM_SPEED_RATE * (float)timestep;
+	gPreviousCamPos = cam.Position();
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE)) glfwSetWindowShouldClose(window, true);
-	if (glfwGetKey(window, GLFW_KEY_A)) cam.ProcessKeyboard(RIGHT, cam_speed);
-	if (glfwGetKey(window, GLFW_KEY_D)) cam.ProcessKeyboard(LEFT, cam_speed);
-	if (glfwGetKey(window, GLFW_KEY_W)) cam.ProcessKeyboard(FORWARD, cam_speed);
-	if (glfwGetKey(window, GLFW_KEY_S)) cam.ProcessKeyboard(BACKWARD, cam_speed);
-	if (glfwGetKey(window, GLFW_KEY_Q)) cam.ProcessKeyboard(UP, cam_speed);
-	if (glfwGetKey(window, GLFW_KEY_E)) cam.ProcessKeyboard(DOWN, cam_speed);
+	if (glfwGetKey(window, GLFW_KEY_A)) cam.Move(RIGHT, move);
+	if (glfwGetKey(window, GLFW_KEY_D)) cam.Move(LEFT, move);
+	if (glfwGetKey(window, GLFW_KEY_W)) cam.Move(FORWARD, move);
+	if (glfwGetKey(window, GLFW_KEY_S)) cam.Move(BACKWARD, move);
+	if (glfwGetKey(window, GLFW_KEY_Q)) cam.Move(UP, move);
+	if (glfwGetKey(window, GLFW_KEY_E)) cam.Move(DOWN, move);
+	// redraw while moving, and once more after stopping to reach the final position
+	bool moving = cam.Position() != gPreviousCamPos;
+	if (moving || gCamMoving)
+		gApp.invalidate();
+	gCamMoving = moving;
+	// mode keys change what is drawn
+	for (int key : { GLFW_KEY_P, GLFW_KEY_O, GLFW_KEY_G, GLFW_KEY_F, GLFW_KEY_Z, GLFW_KEY_X })
+	{
+		if (glfwGetKey(window, key))
+			gApp.invalidate();
+	}
 	if (glfwGetKey(window, GLFW_KEY_P)) ortho = true;
 	if (glfwGetKey(window, GLFW_KEY_O)) ortho = false;
+	if (glfwGetKey(window, GLFW_KEY_G)) deferred = gDeferredAvailable;
+	if (glfwGetKey(window, GLFW_KEY_F)) deferred = false;
+	if (glfwGetKey(window, GLFW_KEY_Z)) depthPrepass = true;
+	if (glfwGetKey(window, GLFW_KEY_X)) depthPrepass = false;
 }
 void mouseInput(GLFWwindow* window, int button, int action, int mods) {
 	std::cout << button << " button..." << std::endl;
@@ -279,10 +710,9 @@ void mouseScrollInput(GLFWwindow* window, double xoffset, double yoffset)
 	std::cout << "speed of camera: " << cam_speed << std::endl;
 }
 
-void cursorPos(GLFWwindow* window, double xPosIn, double yPosIn) {
-	float xpos = static_cast<float>(xPosIn);
-	float ypos = static_cast<float>(yPosIn);
-
+// collects the movement only; a fast mouse reports many positions per frame and
+// UApplyMouseLook turns the camera by their sum once
+void cursorPos(GLFWwindow* window, double xpos, double ypos) {
 	if (firstMouse)
 	{
 		lastX = xpos;
@@ -290,11 +720,25 @@ void cursorPos(GLFWwindow* window, double xPosIn, double yPosIn) {
 		firstMouse = false;
 	}
 
-	float xoffset = xpos - lastX;
-	float yoffset = lastY - ypos;
+	gMouseDeltaX += xpos - lastX;
+	gMouseDeltaY += lastY - ypos;
 	lastX = xpos;
 	lastY = ypos;
-	cam.ProcessMouseMovement(xoffset, yoffset);
+}
+
+// turns the camera by the cursor movement of the last batch of events, right
+// after polling so the next frame shows it rather than waiting for a step
+void UApplyMouseLook()
+{
+	if (gMouseDeltaX == 0.0 && gMouseDeltaY == 0.0)
+		return;
+
+	AllocScope scope(AllocTag::Camera);
+	cam.Turn((float)gMouseDeltaX * SENSITIVITY, (float)gMouseDeltaY * SENSITIVITY);
+	gMouseDeltaX = 0.0;
+	gMouseDeltaY = 0.0;
+	UPublishFrame();
+	gApp.invalidate();
 }
 
 void mouse_click(GLFWwindow* window, int button, int action, int mods) 
@@ -315,35 +759,56 @@ void mouse_click(GLFWwindow* window, int button, int action, int mods)
 	}
 }
 
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes;
+// the next frame resizes the viewport on the thread that owns the context
 void UResizeWindow(GLFWwindow* window, int width, int height)
 {
-	glViewport(0, 0, width, height);
+	gFramebufferWidth = width;
+	gFramebufferHeight = height;
+	UPublishFrame();
+	gApp.invalidate();
 }
 
 
-// Functioned called to render a frame
-void URender()
+// Hands the camera, mode keys and window size as of the latest step to the renderer
+void UPublishFrame()
 {
-	glm::mat4 scale;
-	glm::mat4 rotation;
-	glm::mat4 translation;
-	glm::mat4 model;
-	glm::mat4 projection = glm::mat4(1.0f);
-	glm::mat4 view = glm::mat4(1.0f);
+	FrameState &frame = gFrames.Back();
+	frame.previousPosition = gPreviousCamPos;
+	frame.position = cam.Position();
+	frame.orientation = cam.Orientation();
+	frame.time = gApp.stepTime;
+	frame.ortho = ortho;
+	frame.deferred = deferred;
+	frame.depthPrepass = depthPrepass;
+	frame.width = gFramebufferWidth;
+	frame.height = gFramebufferHeight;
+	gFrames.Publish();
+}
+
+
+// Functioned called to render a frame at the given time, from the newest published step
+void URender(double time)
+{
+	AllocScope scope(AllocTag::Render);
 	glm::mat4 rotateX = glm::mat4(1.0f);
 	glm::mat4 rotateY = glm::mat4(1.0f);
 	glm::vec3 lightBulbPos = glm::vec3(-10.0f, 20.0f, 0.0f);
 	glm::vec3 lightScreenPos = glm::vec3(-12.0f, 15.0f, 20.0f);
-	glm::vec3 viewDir = glm::vec3(cam.Position.x, cam.Position.y, cam.Position.z);
-	GLint modelLoc;
-	GLint viewLoc;
-	GLint projLoc;
-	GLint objectColorLoc;
-	GLint lightBulbLoc;
-	GLint lightScreenLoc;
-	GLint objectTexLoc;
-	GLint viewDirLoc;
+
+	// Hands back what the frame before last allocated; the last frame's stays intact
+	gFrameArena.BeginFrame();
+	UReportAllocations();
+
+	// The newest step, and the window size it saw
+	gFrame = gFrames.Latest();
+	if (gFrame.width != gViewportWidth || gFrame.height != gViewportHeight)
+	{
+		gViewportWidth = gFrame.width;
+		gViewportHeight = gFrame.height;
+		glViewport(0, 0, gViewportWidth, gViewportHeight);
+		gDeferredRenderer.Resize(gViewportWidth, gViewportHeight);
+	}
 
 	// Enable z-depth
 	glEnable(GL_DEPTH_TEST);
@@ -353,38 +818,115 @@ void URender()
 	glClearColor(0,0,0, 0.1f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	// Transforms the camera
-	view = cam.GetViewMatrix();
+	// Transforms the camera, placed between its last two steps so motion stays smooth at any frame rate
+	AllocTracker::SetTag(AllocTag::Camera);
+	float alpha = (float)std::min(std::max((time - gFrame.time) / gApp.timestep, 0.0), 1.0);
+	gFrame.position = glm::mix(gFrame.previousPosition, gFrame.position, alpha);
+	gView.SetPose(gFrame.position, gFrame.orientation);
 	
-	// Creates a orthographic projection
-	ortho ? projection = glm::ortho(-40.0f, (float)WINDOW_WIDTH/10, -20.0f,(float)WINDOW_HEIGHT/10,0.1f, 100.0f) :
-		projection = glm::perspective(glm::radians(45.0f), (GLfloat) WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-
-	// Set the shader to be used
-	glUseProgram(gProgramId);
-
-	// Retrieves and passes transform matrices to the Shader program
-	modelLoc = glGetUniformLocation(gProgramId, "model");
-	viewLoc = glGetUniformLocation(gProgramId, "view");
-	projLoc = glGetUniformLocation(gProgramId, "projection");
-	objectColorLoc = glGetUniformLocation(gProgramId, "objectColor");
-	lightBulbLoc = glGetUniformLocation(gProgramId, "lightBulbColor");
-	lightScreenLoc = glGetUniformLocation(gProgramId, "lightScreenColor");
-	viewDirLoc = glGetUniformLocation(gProgramId, "viewDirection");
-	glUniform3f(glGetUniformLocation(gProgramId, "viewDir"), viewDir.x,viewDir.y, viewDir.z);
-	glUniform3f(glGetUniformLocation(gProgramId, "lightBulbPos"), lightBulbPos.x, lightBulbPos.y, lightBulbPos.z);
-	glProgramUniform4f(gProgramId, lightBulbLoc, LightBulbColor, 1.0f);
-	glUniform3f(glGetUniformLocation(gProgramId, "lightScreenPos"), lightScreenPos.x, lightScreenPos.y, lightScreenPos.z);
-	glProgramUniform4f(gProgramId, lightScreenLoc, MacOsColor,1.0f);
-	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-	glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+	// Creates a orthographic projection; the camera only rebuilds it when the mode changes
+	gFrame.ortho ? gView.SetOrthographic(-40.0f, (float)WINDOW_WIDTH/10, -20.0f,(float)WINDOW_HEIGHT/10,0.1f, 100.0f) :
+		gView.SetPerspective(45.0f, (GLfloat) WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+	const glm::mat4 &view = gView.View();
+	const glm::mat4 &projection = gView.Projection();
+	AllocTracker::SetTag(AllocTag::Render);
+
+	// Sorts the point lights into the clusters of this view and binds their lists
+	float clusterScale[4];
+	gLightClusters.Update(view, projection, 0.1f, 100.0f, gFrameArena.Local());
+	gLightClusters.ShaderScale(gViewportWidth, gViewportHeight, clusterScale);
+
+	// Passes the per-frame uniforms to every shader variant and the deferred
+	// lighting pass; each draw below switches to the cheapest variant for its material
+	auto setFrameUniforms = [&](const ShaderLibrary::Program &program)
+	{
+		glProgramUniform4fv(program.id, program.clusterScale, 1, clusterScale);
+		glProgramUniform3i(program.id, program.clusterGrid, LightClusters::GRID_X, LightClusters::GRID_Y, LightClusters::GRID_Z);
+		glProgramUniformMatrix4fv(program.id, program.view, 1, GL_FALSE, glm::value_ptr(view));
+		glProgramUniformMatrix4fv(program.id, program.projection, 1, GL_FALSE, glm::value_ptr(projection));
+		glProgramUniform3f(program.id, program.lightBulbPos, lightBulbPos.x, lightBulbPos.y, lightBulbPos.z);
+		glProgramUniform4f(program.id, program.lightBulbColor, LightBulbColor, 1.0f);
+		glProgramUniform3f(program.id, program.lightScreenPos, lightScreenPos.x, lightScreenPos.y, lightScreenPos.z);
+		glProgramUniform4f(program.id, program.lightScreenColor, MacOsColor, 1.0f);
+	};
+	for (const ShaderLibrary::Program &program : gShaders.programs)
+	{
+		if (program.ready)
+			setFrameUniforms(program);
+	}
+	if (gDeferredAvailable)
+		setFrameUniforms(gDeferredRenderer.LightingProgram());
+	setFrameUniforms(gDepthProgram);
+	setFrameUniforms(gDepthInstancedProgram);
+	gProgram = nullptr;
+	gBoundSlot = -1;
+
+	// Culls the scene objects and writes their per-object data on the workers,
+	// once for both passes; the draws below only submit the packets
+	gDrawList.Record(gView.FrustumPlanes(), (float)time, &gWorkers, gFrameArena);
+
+	// Deferred draws fill the G-buffer, forward ones shade straight into the window
+	if (gFrame.deferred)
+	{
+		gGeometryTimer.Begin();
+		gDeferredRenderer.BeginGeometry();
+	}
+	else
+	{
+		gForwardTimer.Begin();
+	}
 	
+	// Depth prepass: the scene once with a depth-only shader, so the colour pass
+	// below only shades the fragment that ends up visible in each pixel
+	if (gFrame.depthPrepass)
+	{
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		gDepthPass = true;
+		UDrawScene();
+		gDepthPass = false;
+		gProgram = nullptr;
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+	}
+
+	// Colour pass, counting the fragments that get shaded
+	gOverdrawCounter.Begin();
+	UDrawScene();
+	gOverdrawCounter.End();
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+	gDrawList.Finish();
+
+	// Lights the G-buffer once per pixel
+	if (gFrame.deferred)
+	{
+		gGeometryTimer.End();
+		gLightingTimer.Begin();
+		gDeferredRenderer.Light(view, projection);
+		gLightingTimer.End();
+	}
+	else
+	{
+		gForwardTimer.End();
+	}
+	UReportRenderTimes();
+}
+
+// Draws every object of the scene; run twice per frame with the depth prepass
+void UDrawScene()
+{
+	glm::mat4 scale;
+	glm::mat4 rotation;
+	glm::mat4 translation;
+	glm::mat4 model;
+
 	///////////////////////////////////////////////////////////////////////////////
 	// desk rendering														    //	
 	/////////////////////////////////////////////////////////////////////////////
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gPlaneMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Plane).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(20.0f, 10.0f, 10.0f));
@@ -394,20 +936,19 @@ void URender()
 	translation = glm::translate(glm::vec3(0.0f, -10.0f, -20.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 	
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 0);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(0, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gPlaneMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Plane).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gPlaneMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Plane).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(10.0f, 10.0f, 10.0f));
@@ -417,14 +958,13 @@ void URender()
 	translation = glm::translate(glm::vec3(30.0f, -10.0f, -20.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 	
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 4);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(4, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 	
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gPlaneMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Plane).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
@@ -434,7 +974,7 @@ void URender()
 	/////////////////////////////////////////////////////////////////////////////
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(0.6f, 8.0f, 0.6f));
@@ -444,19 +984,18 @@ void URender()
 	translation = glm::translate(glm::vec3(15.0f, -1.0f, -28.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 5);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(5, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(0.6f, 8.0f, 0.6f));
@@ -466,19 +1005,18 @@ void URender()
 	translation = glm::translate(glm::vec3(16.0f, -1.0f, -27.5f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 5);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(5, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(0.6f, 8.0f, 0.6f));
@@ -488,19 +1026,18 @@ void URender()
 	translation = glm::translate(glm::vec3(13.5f, -1.0f, -28.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 5);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(5, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gCylinderMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Cylinder).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(3.0f, 9.0f, 2.0f));
@@ -510,10 +1047,9 @@ void URender()
 	translation = glm::translate(glm::vec3(15.0f, -10.0f, -28.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 1);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(1, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 36);		//bottom
@@ -524,7 +1060,7 @@ void URender()
 	glBindVertexArray(0);
 
 	// Activate the VBOs contained within the mesh's VAO
-	/*glBindVertexArray(meshes.gTaperedCylinderMesh.vao);
+	/*glBindVertexArray(meshes.Get(MeshPrimitive::TaperedCylinder).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(1.0f, 1.0f, 1.0f));
@@ -534,9 +1070,8 @@ void URender()
 	translation = glm::translate(glm::vec3(-1.2f, 1.0f, 5.5f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glProgramUniform4f(gProgramId, objectColorLoc, 0.0f, 1.0f, 1.0f, 1.0f);
+	USetMaterial(SHADER_STANDARD, glm::vec4(0.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 36);		//bottom
@@ -552,7 +1087,7 @@ void URender()
 	// sphere redering														    //	
 	/////////////////////////////////////////////////////////////////////////////
 
-	glBindVertexArray(meshes.gTorusMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Torus).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(2.3f, 2.3f, 5.0f));
@@ -562,19 +1097,18 @@ void URender()
 	translation = glm::translate(glm::vec3(20.0f, -10.0f, -17.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 6);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(6, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawArrays(GL_TRIANGLES, 0, meshes.gTorusMesh.nVertices);
+	glDrawArrays(GL_TRIANGLES, 0, meshes.Get(MeshPrimitive::Torus).nVertices);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 	
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gSphereMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Sphere).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(3.6f, 4.6f, 3.6f));
@@ -584,14 +1118,13 @@ void URender()
 	translation = glm::translate(glm::vec3(20.0f, -6.0f, -17.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 	//loadImg("reflective_chrome_low_res.JPG","myTexture", 3);
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 9);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(9, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gSphereMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Sphere).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
@@ -601,7 +1134,7 @@ void URender()
 	/////////////////////////////////////////////////////////////////////////////
 	
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(20.0f, 1.0f, 13.0f));
@@ -611,20 +1144,19 @@ void URender()
 	translation = glm::translate(glm::vec3(0.0f, -9.5f, -18.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 	
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 2);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(2, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(20.0f, 13.0f, 0.01f));
@@ -634,19 +1166,18 @@ void URender()
 	translation = glm::translate(glm::vec3(0.0f, -3.0f, -24.7f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 8);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(8, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(20.0f, 13.0f, 0.99f));
@@ -656,21 +1187,20 @@ void URender()
 	translation = glm::translate(glm::vec3(0.0f, -3.0f, -25.3f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 	
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 7);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(7, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	// render trackpad
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(6.0f, 0.01f, 5.0f));
@@ -680,14 +1210,13 @@ void URender()
 	translation = glm::translate(glm::vec3(0.0f, -9.0f, -14.5f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 	
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 3);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(3, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
@@ -695,7 +1224,7 @@ void URender()
 	//render keyboard buttons 
 	for (float key = 0; key < 72.0f; key+=1.5f) {
 		// Activate the VBOs contained within the mesh's VAO
-		glBindVertexArray(meshes.gBoxMesh.vao);
+		glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 		// 1. Scales the object
 		scale = glm::scale(glm::vec3(1.3f, 0.2f, 1.3f));
@@ -716,14 +1245,13 @@ void URender()
 		}
 		// Model matrix: transformations are applied right-to-left order
 		model = translation * rotation * scale;
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 		//lightSourceLoc = glGetUniformLocation(gProgramId, "lightSourceColor");
-		glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 5);
-		glProgramUniform4f(gProgramId, objectColorLoc, 0.0f, 1.0f, 0.0f, 1.0f);
+		UBindTexture(5, model);
+		USetMaterial(SHADER_STANDARD, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f), model);
 
 		// Draws the triangles
-		glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+		glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 		// Deactivate the Vertex Array Object
 		glBindVertexArray(0);
@@ -735,7 +1263,7 @@ void URender()
 	
 	//LightBulb
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gSphereMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Sphere).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(3.0f, 3.0f, 3.0f));
@@ -745,21 +1273,21 @@ void URender()
 	translation = glm::translate(glm::vec3(25.0f, 10.0f, -21.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 3);
-	glProgramUniform4f(gProgramId, objectColorLoc, LightBulbObjColor, 1.0f);
+	UBindTexture(3, model);
+	// the bulb is the light itself, so it glows with its own colour
+	USetMaterial(SHADER_TEXTURED, glm::vec4(LightBulbObjColor, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gSphereMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Sphere).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
     
 	//LightBulb holder
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gConeMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Cone).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(9.0f, 6.0f, 6.0f));
@@ -769,11 +1297,10 @@ void URender()
 	translation = glm::translate(glm::vec3(26.0f, 10.0f, -21.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 3);
-	glProgramUniform4f(gProgramId, objectColorLoc, 0,0,0,0);
+	UBindTexture(3, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(0.0f), model);
 
 	// Draws the triangles
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 36);		//bottom
@@ -785,7 +1312,7 @@ void URender()
 
 	//light stand to light holder
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(1.0f, 7.0f, 0.6f));
@@ -795,20 +1322,19 @@ void URender()
 	translation = glm::translate(glm::vec3(31.0f, 12.0f, -20.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 5);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(5, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	//light stand to base
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gBoxMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Box).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(1.0f, 20.0f, 0.6f));
@@ -818,20 +1344,19 @@ void URender()
 	translation = glm::translate(glm::vec3(33.0f, 1.0f, -20.0f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 5);
-	glProgramUniform4f(gProgramId, objectColorLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+	UBindTexture(5, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), model);
 
 	// Draws the triangles
-	glDrawElements(GL_TRIANGLES, meshes.gBoxMesh.nIndices, GL_UNSIGNED_INT, (void*)0);
+	glDrawElements(GL_TRIANGLES, meshes.Get(MeshPrimitive::Box).nIndices, GL_UNSIGNED_INT, (void*)0);
 
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
 	//light base
 	// Activate the VBOs contained within the mesh's VAO
-	glBindVertexArray(meshes.gConeMesh.vao);
+	glBindVertexArray(meshes.Get(MeshPrimitive::Cone).vao);
 
 	// 1. Scales the object
 	scale = glm::scale(glm::vec3(6.0f, 3.0f, 6.0f));
@@ -841,11 +1366,10 @@ void URender()
 	translation = glm::translate(glm::vec3(33.0f, -9.0f, -20.5f));
 	// Model matrix: transformations are applied right-to-left order
 	model = translation * rotation * scale;
-	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 
 
-	glUniform1i(glGetUniformLocation(gProgramId, "myTexture"), 3);
-	glProgramUniform4f(gProgramId, objectColorLoc, 0, 0, 0, 0);
+	UBindTexture(3, model);
+	USetMaterial(SHADER_STANDARD, glm::vec4(0.0f), model);
 
 	// Draws the triangles
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 36);		//bottom
@@ -855,126 +1379,582 @@ void URender()
 	// Deactivate the Vertex Array Object
 	glBindVertexArray(0);
 
-	// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-	glfwSwapBuffers(gWindow);    // Flips the the back buffer with the front buffer every frame.
+	UDrawObjects();
+}
+
+///////////////////////////////////////////////////
+//	UDrawObjects()
+//
+//	Submit the packets the draw list recorded this
+//	frame, one instanced draw each; the objects' model
+//	matrices and colours are already in its buffer
+///////////////////////////////////////////////////
+void UDrawObjects()
+{
+	for (const DrawList::Packet &packet : gDrawList.packets)
+	{
+		const ShaderLibrary::Program &program = gDepthPass ? gDepthInstancedProgram :
+			gShaders.Get(UPassFeatures(packet.features) | SHADER_INSTANCED);
+		if (&program != gProgram)
+		{
+			glUseProgram(program.id);
+			gProgram = &program;
+			gProgramSlot = -1;
+		}
+		glUniform1ui(program.objectBase, packet.first);
+
+		const DrawList::Mesh &mesh = gDrawList.meshes[packet.mesh];
+		glBindVertexArray(mesh.vao);
+		if (mesh.indexed)
+			glDrawElementsInstanced(GL_TRIANGLES, mesh.count, GL_UNSIGNED_INT, (void*)0, packet.count);
+		else
+			glDrawArraysInstanced(GL_TRIANGLES, 0, mesh.count, packet.count);
+	}
+	glBindVertexArray(0);
 }
 
 // Implements the UCreateShaders function
-bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, GLuint& programId)
+bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, ShaderLibrary &shaders)
 {
-	// Compilation and linkage error reporting
-	int success = 0;
-	char infoLog[512];
+	// every feature combination is started up front, or restored from shader_cache/;
+	// only the standard variant has to be ready before the first frame
+	return shaders.Build(vtxShaderSource, fragShaderSource, gShaderCacheEnabled);
+}
 
-	// Create a Shader program object.
-	programId = glCreateProgram();
+void UDestroyShaderProgram(ShaderLibrary &shaders)
+{
+	shaders.Destroy();
+}
 
-	// Create the vertex and fragment shader objects
-	GLuint vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
-	GLuint fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+TextureHandle loadImg(const char* file, bool flip)
+{
+	// the manager streams the file in on first use, drawing white until then
+	return gTextureManager.Load(file, flip);
+}
 
-	// Retrive the shader source
-	glShaderSource(vertexShaderId, 1, &vtxShaderSource, NULL);
-	glShaderSource(fragmentShaderId, 1, &fragShaderSource, NULL);
+///////////////////////////////////////////////////
+//	UCreatePointLights(int, float)
+//
+//	count: number of lights, 0 for none
+//	radius: distance at which each light fades out
+//
+//	Scatter coloured point lights through the room
+//	around the desk. The seed is fixed so every run
+//	lights the scene the same way.
+///////////////////////////////////////////////////
+void UCreatePointLights(int count, float radius)
+{
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> x(-20.0f, 40.0f);
+	std::uniform_real_distribution<float> y(-9.0f, 15.0f);
+	std::uniform_real_distribution<float> z(-30.0f, -10.0f);
+	std::uniform_real_distribution<float> channel(0.2f, 1.0f);
+
+	// light indices are 16 bits wide in the cluster lists
+	if (count > LightClusters::MAX_LIGHTS)
+	{
+		cout << "lights.count " << count << " is over the " << LightClusters::MAX_LIGHTS << " lights the clusters can index, using "
+			<< LightClusters::MAX_LIGHTS << endl;
+		count = LightClusters::MAX_LIGHTS;
+	}
 
-	// Compile the vertex shader, and print compilation errors (if any)
-	glCompileShader(vertexShaderId); // compile the vertex shader
-	// check for shader compile errors
-	glGetShaderiv(vertexShaderId, GL_COMPILE_STATUS, &success);
-	if (!success)
+	gLightClusters.lights.clear();
+	for (int i = 0; i < count; i++)
 	{
-		glGetShaderInfoLog(vertexShaderId, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+		PointLight light;
+		light.position = glm::vec3(x(random), y(random), z(random));
+		light.radius = radius;
+		light.color = glm::vec3(channel(random), channel(random), channel(random));
+		gLightClusters.lights.push_back(light);
+	}
+}
 
-		return false;
+///////////////////////////////////////////////////
+//	UCreateSceneObjects(int)
+//
+//	count: number of objects, 0 for none
+//
+//	Scatter spinning boxes, spheres and tori through
+//	the room like the point lights, sorted by material
+//	and mesh so the draw list records long packets
+///////////////////////////////////////////////////
+void UCreateSceneObjects(int count)
+{
+	std::mt19937 random(2);
+	std::uniform_real_distribution<float> x(-60.0f, 80.0f);
+	std::uniform_real_distribution<float> y(-9.0f, 40.0f);
+	std::uniform_real_distribution<float> z(-90.0f, 30.0f);
+	std::uniform_real_distribution<float> size(0.2f, 0.8f);
+	std::uniform_real_distribution<float> channel(0.2f, 1.0f);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+	const unsigned MATERIALS[] = { SHADER_LIT, SHADER_LIT | SHADER_SPECULAR };
+
+	gDrawList.objects.clear();
+	for (int i = 0; i < count; i++)
+	{
+		SceneObject object;
+		object.mesh = (unsigned)(random() % gDrawList.meshes.size());
+		object.features = MATERIALS[random() % 2];
+		object.color = glm::vec4(channel(random), channel(random), channel(random), 1.0f);
+		object.position = glm::vec3(x(random), y(random), z(random));
+		object.scale = size(random);
+		glm::vec3 axis(direction(random), direction(random), direction(random));
+		object.axis = glm::length(axis) > 0.01f ? glm::normalize(axis) : glm::vec3(0.0f, 1.0f, 0.0f);
+		object.spin = direction(random) * 2.0f;
+		gDrawList.objects.push_back(object);
 	}
+	std::sort(gDrawList.objects.begin(), gDrawList.objects.end(), [](const SceneObject &a, const SceneObject &b)
+	{
+		return a.features != b.features ? a.features < b.features : a.mesh < b.mesh;
+	});
+}
+
+// Prints the average GPU time of whichever path drew the last REPORT_FRAMES frames,
+// so the forward and deferred paths, with and without the depth prepass, can be
+// compared on the same view. Overdraw is fragments shaded per pixel on screen.
+void UReportRenderTimes()
+{
+	if (!gReportTimes || ++gReportFrame < REPORT_FRAMES)
+		return;
+	gReportFrame = 0;
+
+	double samples;
+	if (gOverdrawCounter.Average(samples))
+		cout << "overdraw: " << samples / ((double)gViewportWidth * gViewportHeight) << " fragments shaded per pixel"
+			<< (gFrame.depthPrepass ? " (depth prepass)" : "") << endl;
+
+	double forward, geometry, lighting;
+	if (gForwardTimer.Average(forward))
+		cout << "forward: " << forward << " ms" << endl;
+	if (gGeometryTimer.Average(geometry) && gLightingTimer.Average(lighting))
+		cout << "deferred: " << geometry + lighting << " ms (geometry " << geometry << " ms, lighting " << lighting << " ms)" << endl;
+	if (!gDrawList.objects.empty())
+		cout << "draw list: " << gDrawList.VisibleCount() << " of " << gDrawList.objects.size() << " objects in "
+			<< gDrawList.packets.size() << " draws, recorded in " << gDrawList.RecordMilliseconds() << " ms" << endl;
+	cout << "frame arena: " << gFrameArena.Used() / 1024 << " KB used, peak " << gFrameArena.HighWater() / 1024
+		<< " KB of " << gFrameArena.Capacity() / 1024 << " KB" << endl;
+}
+
+// Closes the allocation counters of the frame before this one; prints them every
+// gAllocReportFrames frames and for the first frame over the budget after the warm-up
+void UReportAllocations()
+{
+	if (!AllocTracker::Enabled())
+		return;
+	AllocTracker::BeginFrame();
+	AllocTracker::Counters frame = AllocTracker::Frame();
+
+	bool over = gAllocBudget >= 0 && ++gAllocFramesDrawn > gAllocWarmup && frame.allocations > (size_t)gAllocBudget;
+	if (over)
+		gAllocFramesOver++;
+	bool report = gAllocReportFrames > 0 && ++gAllocReportFrame >= gAllocReportFrames;
+	if (report)
+		gAllocReportFrame = 0;
+	if (!report && !(over && gAllocFramesOver == 1))
+		return;
+
+	cout << (over ? "allocations over budget: " : "allocations: ") << frame.allocations << " in the last frame ("
+		<< frame.bytes << " bytes, " << frame.frees << " frees, peak " << frame.peak / 1024 << " KB), "
+		<< AllocTracker::Live() / 1024 << " KB live;";
+	for (int tag = 0; tag < ALLOC_TAG_COUNT; tag++)
+	{
+		AllocTracker::Counters counters = AllocTracker::Frame((AllocTag)tag);
+		cout << " " << AllocTracker::Name((AllocTag)tag) << " " << counters.allocations << " (" << counters.bytes << " bytes)";
+	}
+	cout << endl;
+}
+
+///////////////////////////////////////////////////
+//	UBuildAtlas()
+//
+//	Pack the scene textures small enough to share a page,
+//	reusing the layout cached in texture_cache/ when the
+//	same images are still there at the same sizes
+///////////////////////////////////////////////////
+void UBuildAtlas()
+{
+	if (!gConfig.GetBool("texture.atlas", true))
+		return;
+
+	vector<TextureAtlas::Source> sources;
+	for (int i = 0; i < SCENE_TEXTURE_COUNT; i++)
+		sources.push_back({ SCENE_TEXTURES[i].file, SCENE_TEXTURES[i].flip });
+
+	gAtlas.Build(sources, gConfig.GetInt("texture.atlasSize", 2048), gConfig.GetInt("texture.atlasMaxImageSize", 1024),
+		gConfig.GetInt("texture.atlasPadding", 8));
+}
+
+///////////////////////////////////////////////////
+//	ULoadSceneTextures()
+//
+//	Give every scene texture a handle: packed ones share
+//	their atlas page's, the rest get their own
+///////////////////////////////////////////////////
+void ULoadSceneTextures()
+{
+	UBuildAtlas();
 
-	glCompileShader(fragmentShaderId); // compile the fragment shader
-	// check for shader compile errors
-	glGetShaderiv(fragmentShaderId, GL_COMPILE_STATUS, &success);
-	if (!success)
+	vector<TextureHandle> pages;
+	for (int page = 0; page < gAtlas.pageCount; page++)
+		pages.push_back(gTextureManager.LoadAtlasPage(&gAtlas, page));
+
+	for (int i = 0; i < SCENE_TEXTURE_COUNT; i++)
 	{
-		glGetShaderInfoLog(fragmentShaderId, sizeof(infoLog), NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+		TextureSlot &slot = gTextureSlots[i];
+		int entry = gAtlas.Find(SCENE_TEXTURES[i].file, SCENE_TEXTURES[i].flip);
+		if (entry < 0)
+		{
+			slot.texture = loadImg(SCENE_TEXTURES[i].file, SCENE_TEXTURES[i].flip);
+			slot.uvTransform[0] = slot.uvTransform[1] = 1.0f;
+			slot.uvTransform[2] = slot.uvTransform[3] = 0.0f;
+		}
+		else
+		{
+			slot.texture = pages[gAtlas.entries[entry].page];
+			gAtlas.UVTransform(entry, slot.uvTransform);
+		}
+	}
+}
+
+///////////////////////////////////////////////////
+//	UBindTexture(int, const glm::mat4&)
+//
+//	slot: index into SCENE_TEXTURES
+//	model: model matrix of the object about to be drawn
+//
+//	Bind a scene texture, which also marks it used this
+//	frame and raises its streaming priority to the
+//	object's size on screen. Textures on the same atlas
+//	page only change the uv transform USetMaterial passes
+//	to the shader.
+///////////////////////////////////////////////////
+void UBindTexture(int slot, const glm::mat4 &model)
+{
+	// depth needs no textures, and the colour pass counts the use
+	if (gDepthPass)
+		return;
+
+	const TextureSlot &texture = gTextureSlots[slot];
+	gTextureManager.Bind(texture.texture, 0, UScreenSize(model));
+	gBoundSlot = slot;
+}
+
+// The material's features plus what the active path adds: the G-buffer
+// outputs when deferred, otherwise the clustered point lights if there are any
+unsigned UPassFeatures(unsigned features)
+{
+	if (gFrame.deferred)
+		return features | SHADER_GBUFFER;
+	if (!gLightClusters.lights.empty())
+		return features | SHADER_CLUSTERED;
+	return features;
+}
 
-		return false;
+///////////////////////////////////////////////////
+//	USetMaterial(unsigned, const glm::vec4&, const glm::mat4&)
+//
+//	features: ShaderFeature bits the material asks for
+//	color: objectColor of the draw
+//	model: model matrix of the object about to be drawn
+//
+//	Switch to the cheapest shader variant that draws the
+//	material correctly, with the clustered point lights
+//	added to lit ones, and pass it the per-draw uniforms.
+//	The depth prepass only needs the model matrix.
+///////////////////////////////////////////////////
+void USetMaterial(unsigned features, const glm::vec4 &color, const glm::mat4 &model)
+{
+	if (gDepthPass)
+	{
+		if (gProgram != &gDepthProgram)
+		{
+			glUseProgram(gDepthProgram.id);
+			gProgram = &gDepthProgram;
+		}
+		glUniformMatrix4fv(gDepthProgram.model, 1, GL_FALSE, glm::value_ptr(model));
+		return;
 	}
 
-	// Attached compiled shaders to the shader program
-	glAttachShader(programId, vertexShaderId);
-	glAttachShader(programId, fragmentShaderId);
+	const ShaderLibrary::Program &program = gShaders.Get(ShaderLibrary::Cheapest(UPassFeatures(features), glm::value_ptr(color)));
+	if (&program != gProgram)
+	{
+		glUseProgram(program.id);
+		gProgram = &program;
+		gProgramSlot = -1;
+	}
 
-	glLinkProgram(programId);   // links the shader program
-	// check for linking errors
-	glGetProgramiv(programId, GL_LINK_STATUS, &success);
-	if (!success)
+	glUniformMatrix4fv(program.model, 1, GL_FALSE, glm::value_ptr(model));
+	glUniform4fv(program.objectColor, 1, glm::value_ptr(color));
+	if (gBoundSlot >= 0 && gBoundSlot != gProgramSlot)
 	{
-		glGetProgramInfoLog(programId, sizeof(infoLog), NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		glUniform4fv(program.uvTransform, 1, gTextureSlots[gBoundSlot].uvTransform);
+		gProgramSlot = gBoundSlot;
+	}
+}
+
+///////////////////////////////////////////////////
+//	UScreenSize(const glm::mat4&)
+//
+//	Rough share of the screen height an object covers,
+//	from the bounding sphere of a unit mesh under 'model'
+///////////////////////////////////////////////////
+float UScreenSize(const glm::mat4 &model)
+{
+	float radius = std::max(glm::length(glm::vec3(model[0])), std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+	if (gFrame.ortho)
+		return radius / 40.0f;	// half the height of the orthographic view
 
-		return false;
+	float distance = glm::length(glm::vec3(model[3]) - gFrame.position);
+	return radius / std::max(distance * tanf(glm::radians(45.0f) * 0.5f), 0.001f);
+}
+
+// Builds (or with verifyOnly, checks) the compressed cache entry of every scene texture.
+// Verification re-encodes each image, compares the bytes with its entry and reports the PSNR.
+int UTextureCacheTool(bool verifyOnly)
+{
+	const double minPSNR = gConfig.GetFloat("texture.cacheMinPSNR", 25.0f);
+	bool ok = true;
+
+	for (int i = 0; i < SCENE_TEXTURE_COUNT; i++)
+	{
+		const SceneTexture &texture = SCENE_TEXTURES[i];
+		if (verifyOnly)
+		{
+			TextureCache::VerifyReport report = TextureCache::Verify(texture.file, texture.flip, &gWorkers);
+			if (!report.sourceLoaded)
+			{
+				cout << texture.file << ": source not found, skipped" << endl;
+				continue;
+			}
+
+			bool passed = report.cacheFound && report.matchesCache && report.psnr >= minPSNR;
+			ok = ok && passed;
+			cout << texture.file << ": " << report.levels << " levels, "
+				<< report.sourceBytes / 1024 << " KB -> " << report.compressedBytes / 1024 << " KB, PSNR "
+				<< report.psnr << " dB, cache " << (!report.cacheFound ? "missing" : report.matchesCache ? "matches" : "differs")
+				<< (passed ? "" : "  FAILED") << endl;
+		}
+		else
+		{
+			int width, height, channels;
+			unsigned char* pixels = TextureCache::DecodeSource(texture.file, texture.flip, width, height, channels);
+			if (!pixels)
+			{
+				cout << texture.file << ": source not found, skipped" << endl;
+				continue;
+			}
+
+			std::vector<unsigned char> scaled;
+			bool fitted = TextureCache::FitToBudget(texture.file, pixels, width, height, channels, scaled, &gWorkers);
+
+			TextureData data;
+			TextureCache::Build(fitted ? scaled.data() : pixels, width, height, channels, data, &gWorkers);
+			data.maxDimension = TextureCache::MaxDimension(texture.file);
+			stbi_image_free(pixels);
+
+			bool saved = TextureCache::Save(texture.file, texture.flip, data);
+			ok = ok && saved;
+			cout << TextureCache::EntryPath(texture.file, texture.flip) << (saved ? ": written" : ": write failed") << endl;
+		}
 	}
 
-	glUseProgram(programId);    // Uses the shader program
+	// atlas pages are composited from the sources, so they are rebuilt rather than verified
+	if (!verifyOnly)
+	{
+		UBuildAtlas();
+		for (int page = 0; page < gAtlas.pageCount; page++)
+		{
+			TextureData data;
+			bool built = gAtlas.LoadPage(page, data, &gWorkers, true);
+			ok = ok && built;
+			cout << "atlas page " << page << (built ? ": written" : ": build failed") << endl;
+		}
+	}
 
-	return true;
+	gWorkers.Stop();
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
-void UDestroyShaderProgram(GLuint programId)
+// Times full mip chain generation of every scene texture for each filter, on one
+// thread and on the worker pool. Throughput counts the pixels read from every level.
+int UMipmapBenchmark()
 {
-	glDeleteProgram(programId);
+	struct Image
+	{
+		std::vector<unsigned char> pixels;
+		int width, height, channels;
+	};
+	std::vector<Image> images;
+	for (int i = 0; i < SCENE_TEXTURE_COUNT; i++)
+	{
+		Image image;
+		unsigned char* pixels = TextureCache::DecodeSource(SCENE_TEXTURES[i].file, SCENE_TEXTURES[i].flip, image.width, image.height, image.channels);
+		if (!pixels)
+			continue;
+		image.pixels.assign(pixels, pixels + (size_t)image.width * image.height * image.channels);
+		stbi_image_free(pixels);
+		images.push_back(image);
+	}
+	if (images.empty())
+	{
+		cout << "no scene textures found" << endl;
+		gWorkers.Stop();
+		return EXIT_FAILURE;
+	}
+
+	const int REPEATS = 3;
+	const MipFilter filters[] = { MipFilter::Box, MipFilter::Kaiser };
+	for (MipFilter filter : filters)
+	{
+		for (WorkerPool* workers : { (WorkerPool*)nullptr, &gWorkers })
+		{
+			double pixelsRead = 0.0;
+			auto start = std::chrono::steady_clock::now();
+			for (int repeat = 0; repeat < REPEATS; repeat++)
+			{
+				for (const Image &image : images)
+				{
+					std::vector<unsigned char> current = image.pixels;
+					std::vector<unsigned char> next;
+					for (int w = image.width, h = image.height; w > 1 || h > 1; w = MipGenerator::NextSize(w), h = MipGenerator::NextSize(h))
+					{
+						next.resize((size_t)MipGenerator::NextSize(w) * MipGenerator::NextSize(h) * image.channels);
+						MipGenerator::Downsample(current.data(), w, h, image.channels, next.data(), filter, true, workers);
+						current.swap(next);
+						pixelsRead += (double)w * h;
+					}
+				}
+			}
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			cout << MipGenerator::FilterName(filter) << ", " << (workers ? workers->ThreadCount() + 1 : 1) << " thread(s): "
+				<< pixelsRead / seconds / 1.0e6 << " MP/s" << endl;
+		}
+	}
+
+	gWorkers.Stop();
+	return EXIT_SUCCESS;
 }
 
-void loadImg(const char* file, int memoryLoc)
+// Times generating every primitive, with and without optimizing, on one thread and on
+// the worker pool, and reading each back from a cache entry. Needs no window or GPU.
+int UMeshBenchmark()
 {
-	unsigned int textures;
-	//create our image texture
-	glGenTextures(1, &textures);
-	
-	// OpenGL has 32(at least in this version) available textures starting from 33984-34015
-	GLenum activeTexture = 33984+memoryLoc;
-	std::cout << "GL_TEXTURE" << activeTexture - 33984 << " = " << activeTexture << std::endl;
-	glActiveTexture(activeTexture);
-	glBindTexture(GL_TEXTURE_2D, textures);
-
-	//texture wrapping
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	//texture filtering
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	int width, height, nrChannels;
-	unsigned char* data =
-		stbi_load
-		(
-			file,
-			&width,
-			&height,
-			&nrChannels,
-			0
-		);
-	if (data)
-	{
-		std::cout << "loaded image..." << std::endl;
-		glTexImage2D
-		(
-			GL_TEXTURE_2D,
-			0, GL_RGB, width,
-			height,
-			0,
-			GL_RGB,
-			GL_UNSIGNED_BYTE,
-			data
-		);
-		glGenerateMipmap(GL_TEXTURE_2D);
+	const int REPEATS = 200;
+	std::vector<MeshData> data(MESH_PRIMITIVE_COUNT);
+	for (int i = 0; i < MESH_PRIMITIVE_COUNT; i++)
+	{
+		MeshPrimitive primitive = (MeshPrimitive)i;
+		MeshLibrary::Generate(primitive, data[i]);
+		cout << MeshLibrary::Name(primitive) << ": " << data[i].VertexCount() << " vertices, " << data[i].indices.size()
+			<< " indices, " << data[i].ByteCount() / 1024.0 << " KB, radius " << data[i].radius << endl;
+	}
+
+	auto time = [&](const char* what, const std::function<void(int)> &body, WorkerPool* workers)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int repeat = 0; repeat < REPEATS; repeat++)
+		{
+			if (workers)
+			{
+				workers->ParallelFor(MESH_PRIMITIVE_COUNT, body);
+			}
+			else
+			{
+				for (int i = 0; i < MESH_PRIMITIVE_COUNT; i++)
+					body(i);
+			}
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		cout << what << ", " << (workers ? workers->ThreadCount() + 1 : 1) << " thread(s): "
+			<< seconds * 1000.0 / REPEATS << " ms for all primitives" << endl;
+	};
+
+	for (WorkerPool* workers : { (WorkerPool*)nullptr, &gWorkers })
+	{
+		time("generate and optimize", [&](int i) { MeshLibrary::Generate((MeshPrimitive)i, data[i]); }, workers);
+		time("optimize only", [&](int i)
+		{
+			MeshData copy = data[i];
+			MeshLibrary::Optimize(copy);
+		}, workers);
+	}
+
+	bool ok = true;
+	for (int i = 0; i < MESH_PRIMITIVE_COUNT; i++)
+		ok = MeshLibrary::Save((MeshPrimitive)i, data[i]) && ok;
+	if (ok)
+	{
+		time("read from mesh_cache", [&](int i) { MeshLibrary::Load((MeshPrimitive)i, data[i]); }, nullptr);
 	}
 	else
 	{
-		std::cout << "Texture failed to load..." << std::endl;
+		cout << "mesh_cache entries could not be written" << endl;
 	}
-	stbi_set_flip_vertically_on_load(1);
-	stbi_image_free(data);
-	
+
+	gWorkers.Stop();
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Records the draw list frame after frame, headless, with scene.objects raised to
+// enough slices to run on the workers, and fails if any frame after the warm-up
+// allocates more than memory.allocationBudget times, 0 when that is unset. Needs a
+// build with TRACK_ALLOCATIONS and no window or GPU.
+int UAllocationCheck()
+{
+	const int FRAMES = 600;
+	const int MIN_OBJECTS = 16384;		// 16 slices
+	if (!AllocTracker::Enabled())
+	{
+		cout << "Allocation counts need a build with TRACK_ALLOCATIONS defined" << endl;
+		gWorkers.Stop();
+		return EXIT_FAILURE;
+	}
+	int warmup = gConfig.GetInt("memory.allocationWarmup", 300);
+	size_t budget = (size_t)std::max(gConfig.GetInt("memory.allocationBudget", -1), 0);
+
+	// the scene's meshes, only their bounds matter without a GPU
+	const MeshPrimitive primitives[] = { MeshPrimitive::Box, MeshPrimitive::Sphere, MeshPrimitive::Torus };
+	for (MeshPrimitive primitive : primitives)
+	{
+		MeshData data;
+		MeshLibrary::Generate(primitive, data);
+		gDrawList.meshes.push_back({ 0, 0, true, data.radius });
+	}
+	UCreateSceneObjects(std::max(gConfig.GetInt("scene.objects", 0), MIN_OBJECTS));
+	gFrameArena.Initialize(&gWorkers, (size_t)gConfig.GetInt("memory.frameArenaKB", 256) * 1024);
+	gDrawList.InitializeHeadless(gDrawList.objects.size());
+
+	QuaternionCamera view;
+	view.SetPerspective(45.0f, (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+	int framesOver = 0;
+	size_t most = 0;
+	// each pass closes the counters of the frame before it, so one more
+	// pass after the last recorded frame checks that frame as well
+	for (int frame = 0; frame <= warmup + FRAMES; frame++)
+	{
+		gFrameArena.BeginFrame();
+		AllocTracker::BeginFrame();
+		if (frame > warmup)
+		{
+			size_t allocations = AllocTracker::Frame().allocations;
+			most = std::max(most, allocations);
+			if (allocations > budget)
+				framesOver++;
+		}
+		if (frame == warmup + FRAMES)
+			break;
+
+		// turning, so the culled set and the packets change from frame to frame
+		view.Turn(0.25f, 0.0f);
+		gDrawList.Record(view.FrustumPlanes(), frame / 60.0f, &gWorkers, gFrameArena);
+		gDrawList.Finish();
+	}
+	cout << "draw list: " << gDrawList.objects.size() << " objects on " << gWorkers.ThreadCount() + 1 << " thread(s), "
+		<< FRAMES << " frames after a " << warmup << " frame warm-up: at most " << most << " allocations per frame, "
+		<< framesOver << " frames over the budget of " << budget << endl;
+
+	gDrawList.Shutdown();
+	gWorkers.Stop();
+	return framesOver == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocTracker.cpp
+// ========
+// heap allocation counters per subsystem and per frame
+//
+//	With TRACK_ALLOCATIONS every block comes from malloc with a small header
+//	in front holding the tag and size it was counted under, so a delete on
+//	another thread or in another subsystem takes it off the right counters.
+//	The counters are plain arrays of atomics, constant initialized, so they
+//	work for allocations before main and never allocate themselves.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "allocTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+	const char* const TAG_NAMES[ALLOC_TAG_COUNT] = { "other", "meshes", "textures", "render", "camera" };
+
+	struct TagCounters
+	{
+		std::atomic<size_t> allocations{ 0 };
+		std::atomic<size_t> frees{ 0 };
+		std::atomic<size_t> bytes{ 0 };
+		std::atomic<size_t> live{ 0 };		// totals only
+		std::atomic<size_t> peak{ 0 };
+	};
+
+	// since the start, and of the frame under way
+	TagCounters gTotal[ALLOC_TAG_COUNT];
+	TagCounters gFrame[ALLOC_TAG_COUNT];
+	// the last frame BeginFrame closed
+	AllocTracker::Counters gLastFrame[ALLOC_TAG_COUNT];
+
+	thread_local AllocTag tTag = AllocTag::Other;
+
+#ifdef TRACK_ALLOCATIONS
+	// in front of every tracked block: what freeing it needs to count and release it
+	struct Header
+	{
+		void* block;
+		size_t size;
+		AllocTag tag;
+	};
+
+	void RaisePeak(std::atomic<size_t> &peak, size_t live)
+	{
+		size_t seen = peak.load(std::memory_order_relaxed);
+		while (live > seen && !peak.compare_exchange_weak(seen, live, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void* Track(size_t size, size_t alignment, AllocTag tag)
+	{
+		alignment = std::max(alignment, alignof(std::max_align_t));
+		void* block = std::malloc(size + alignment + sizeof(Header));
+		if (!block)
+			return nullptr;
+		uintptr_t user = ((uintptr_t)block + sizeof(Header) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		Header* header = (Header*)user - 1;
+		header->block = block;
+		header->size = size;
+		header->tag = tag;
+
+		TagCounters &total = gTotal[(int)tag];
+		TagCounters &frame = gFrame[(int)tag];
+		size_t live = total.live.fetch_add(size, std::memory_order_relaxed) + size;
+		total.allocations.fetch_add(1, std::memory_order_relaxed);
+		total.bytes.fetch_add(size, std::memory_order_relaxed);
+		RaisePeak(total.peak, live);
+		frame.allocations.fetch_add(1, std::memory_order_relaxed);
+		frame.bytes.fetch_add(size, std::memory_order_relaxed);
+		RaisePeak(frame.peak, live);
+		return (void*)user;
+	}
+
+	void Untrack(void* pointer)
+	{
+		if (!pointer)
+			return;
+		Header* header = (Header*)pointer - 1;
+		gTotal[(int)header->tag].live.fetch_sub(header->size, std::memory_order_relaxed);
+		gTotal[(int)header->tag].frees.fetch_add(1, std::memory_order_relaxed);
+		gFrame[(int)header->tag].frees.fetch_add(1, std::memory_order_relaxed);
+		std::free(header->block);
+	}
+#endif
+}
+
+bool AllocTracker::Enabled()
+{
+#ifdef TRACK_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+const char* AllocTracker::Name(AllocTag tag)
+{
+	return TAG_NAMES[(int)tag];
+}
+
+AllocTag AllocTracker::SetTag(AllocTag tag)
+{
+	AllocTag previous = tTag;
+	tTag = tag;
+	return previous;
+}
+
+///////////////////////////////////////////////////
+//	BeginFrame()
+//
+//	Move the running frame counters to the ones
+//	Frame() reads and start the next frame from
+//	zero, its peaks from what is alive right now
+///////////////////////////////////////////////////
+void AllocTracker::BeginFrame()
+{
+	for (int tag = 0; tag < ALLOC_TAG_COUNT; tag++)
+	{
+		Counters &last = gLastFrame[tag];
+		last.allocations = gFrame[tag].allocations.exchange(0, std::memory_order_relaxed);
+		last.frees = gFrame[tag].frees.exchange(0, std::memory_order_relaxed);
+		last.bytes = gFrame[tag].bytes.exchange(0, std::memory_order_relaxed);
+		last.peak = gFrame[tag].peak.exchange(gTotal[tag].live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+AllocTracker::Counters AllocTracker::Frame(AllocTag tag)
+{
+	return gLastFrame[(int)tag];
+}
+
+AllocTracker::Counters AllocTracker::Total(AllocTag tag)
+{
+	const TagCounters &total = gTotal[(int)tag];
+	Counters counters;
+	counters.allocations = total.allocations.load(std::memory_order_relaxed);
+	counters.frees = total.frees.load(std::memory_order_relaxed);
+	counters.bytes = total.bytes.load(std::memory_order_relaxed);
+	counters.peak = total.peak.load(std::memory_order_relaxed);
+	return counters;
+}
+
+// the peaks of different tags fall at different times, so the sum is an upper bound
+AllocTracker::Counters AllocTracker::Frame()
+{
+	Counters sum;
+	for (const Counters &frame : gLastFrame)
+	{
+		sum.allocations += frame.allocations;
+		sum.frees += frame.frees;
+		sum.bytes += frame.bytes;
+		sum.peak += frame.peak;
+	}
+	return sum;
+}
+
+size_t AllocTracker::Live()
+{
+	size_t live = 0;
+	for (const TagCounters &total : gTotal)
+		live += total.live.load(std::memory_order_relaxed);
+	return live;
+}
+
+void* AllocTracker::Malloc(size_t size, AllocTag tag)
+{
+#ifdef TRACK_ALLOCATIONS
+	return Track(size, 0, tag);
+#else
+	(void)tag;
+	return std::malloc(size);
+#endif
+}
+
+void* AllocTracker::Realloc(void* pointer, size_t size, AllocTag tag)
+{
+#ifdef TRACK_ALLOCATIONS
+	if (!pointer)
+		return Track(size, 0, tag);
+	void* moved = Track(size, 0, tag);
+	if (!moved)
+		return nullptr;
+	memcpy(moved, pointer, std::min(((const Header*)pointer - 1)->size, size));
+	Untrack(pointer);
+	return moved;
+#else
+	(void)tag;
+	return std::realloc(pointer, size);
+#endif
+}
+
+void AllocTracker::Free(void* pointer)
+{
+#ifdef TRACK_ALLOCATIONS
+	Untrack(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+
+#ifdef TRACK_ALLOCATIONS
+// Replacements of the global allocation functions, counted under the calling
+// thread's tag; the array, nothrow and sized forms forward to these
+void* operator new(size_t size)
+{
+	void* pointer = Track(size, 0, tTag);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* pointer = Track(size, (size_t)alignment, tTag);
+	if (!pointer)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	Untrack(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	Untrack(pointer);
+}
+#endif
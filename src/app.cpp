@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////
+// app.cpp
+// ========
+// Window, GL context and main loop: the simulation advances in fixed steps
+// and each frame is drawn between the last two of them, so behaviour is the
+// same at 30 or 500 frames per second
+///////////////////////////////////////////////////////////////////////////////
+
+#include "app.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+app::app(const char* title, int width, int height)
+	: width(width), height(height), title(title)
+{
+}
+
+bool app::open()
+{
+	// GLFW: initialize and configure
+	// ------------------------------
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+#ifdef __APPLE__
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+
+	// GLFW: window creation
+	// ---------------------
+	window = glfwCreateWindow(width, height, title, NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return false;
+	}
+	glfwMakeContextCurrent(window);
+	// the system lost the window contents (uncovered, restored), so the last frame is gone
+	glfwSetWindowUserPointer(window, this);
+	glfwSetWindowRefreshCallback(window, [](GLFWwindow* window)
+	{
+		static_cast<app*>(glfwGetWindowUserPointer(window))->invalidate();
+	});
+
+	// GLEW: initialize
+	// ----------------
+	// Note: if using GLEW version 1.13 or earlier
+	glewExperimental = GL_TRUE;
+	GLenum GlewInitResult = glewInit();
+
+	if (GLEW_OK != GlewInitResult)
+	{
+		std::cerr << glewGetErrorString(GlewInitResult) << std::endl;
+		return false;
+	}
+
+	// Displays GPU OpenGL version
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+
+	return true;
+}
+
+// runs every step the real time in lag covers; after a long stall (a
+// breakpoint, a dragged window) drops what is left rather than spiral
+int app::simulate(Clock::duration &lag, Clock::time_point frameStart)
+{
+	int steps = 0;
+	while (lag >= step)
+	{
+		if (steps == maxSteps)
+		{
+			lag = Clock::duration::zero();
+			break;
+		}
+		stepTime = seconds(frameStart - lag + step);
+		if (update)
+			update(timestep);
+		lag -= step;
+		steps++;
+	}
+	return steps;
+}
+
+// frame limiter: sleep most of the way, then yield for the last stretch
+// since sleeps can overshoot by a scheduler tick
+void app::limitFrame(Clock::time_point frameStart) const
+{
+	if (frameLimit <= 0.0)
+		return;
+	Clock::time_point frameEnd = frameStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameLimit));
+	std::this_thread::sleep_until(frameEnd - std::chrono::milliseconds(2));
+	while (Clock::now() < frameEnd)
+		std::this_thread::yield();
+}
+
+double app::seconds(Clock::time_point time) const
+{
+	return std::chrono::duration<double>(time - start).count();
+}
+
+void app::invalidate()
+{
+	redraw = true;
+	if (renderThread)
+	{
+		// taken so the wake-up cannot slip in between the render thread
+		// checking redraw and going to sleep
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		wake.notify_one();
+	}
+}
+
+void app::run()
+{
+	start = Clock::now();
+	step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timestep));
+	Clock::time_point previous = start;
+	Clock::duration lag = Clock::duration::zero();
+
+	if (renderThread)
+	{
+		// hand the context over, and keep this thread to events and steps
+		// only, sleeping until input arrives or the next step is due
+		glfwMakeContextCurrent(NULL);
+		running = true;
+		std::thread renderer(&app::renderLoop, this);
+		while (!glfwWindowShouldClose(window))
+		{
+			glfwWaitEventsTimeout(std::chrono::duration<double>(step - lag).count());
+			if (input)
+				input();
+			Clock::time_point now = Clock::now();
+			lag += now - previous;
+			previous = now;
+			simulate(lag, now);
+		}
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			running = false;
+		}
+		wake.notify_one();
+		renderer.join();
+		glfwMakeContextCurrent(window);
+		return;
+	}
+
+	glfwSwapInterval(vsync ? 1 : 0);
+
+	// on demand: the scene changed recently, so held keys may still be moving it
+	bool active = true;
+	while (!glfwWindowShouldClose(window))
+	{
+		Clock::time_point frameStart = Clock::now();
+		if (onDemand && !redraw)
+		{
+			// nothing to show: while the scene was just changing, wait no longer
+			// than the next step so held keys keep it moving; otherwise sleep until
+			// input or the timeout and run one step at once, so keys pressed
+			// meanwhile are seen without delay, rather than catching up on idle time
+			glfwWaitEventsTimeout(active ? std::chrono::duration<double>(step - lag).count() : idleTimeout);
+			frameStart = Clock::now();
+			lag = active ? lag + (frameStart - previous) : std::max(lag, step);
+		}
+		else
+		{
+			glfwPollEvents();
+			lag += frameStart - previous;
+		}
+		previous = frameStart;
+		if (input)
+			input();
+
+		int steps = simulate(lag, frameStart);
+
+		// on demand the previous frame stays up until something changes;
+		// cleared first so render can ask for the next one
+		if (onDemand && !redraw)
+		{
+			active = active && steps == 0;
+			continue;
+		}
+		redraw = false;
+		active = true;
+
+		if (render)
+			render(seconds(frameStart));
+		glfwSwapBuffers(window);    // Flips the the back buffer with the front buffer every frame.
+		limitFrame(frameStart);
+	}
+}
+
+// Render thread: draws whenever asked (or always, unless on demand) with the
+// newest state update published, never more than one frame ahead of the GPU
+void app::renderLoop()
+{
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(vsync ? 1 : 0);
+
+	GLsync previousFrame = 0;
+	while (running)
+	{
+		if (onDemand)
+		{
+			std::unique_lock<std::mutex> lock(wakeMutex);
+			wake.wait_for(lock, std::chrono::duration<double>(idleTimeout), [this] { return redraw || !running; });
+			if (!redraw)
+				continue;
+		}
+		redraw = false;
+
+		Clock::time_point frameStart = Clock::now();
+		if (render)
+			render(seconds(frameStart));
+		glfwSwapBuffers(window);
+
+		// wait for the GPU to finish the frame before this one, so the driver
+		// cannot queue frames up and delay the newest input reaching the screen
+		GLsync frame = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		if (previousFrame)
+		{
+			glClientWaitSync(previousFrame, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+			glDeleteSync(previousFrame);
+		}
+		previousFrame = frame;
+		limitFrame(frameStart);
+	}
+
+	if (previousFrame)
+		glDeleteSync(previousFrame);
+	glfwMakeContextCurrent(NULL);
+}
@@ -0,0 +1,471 @@
+///////////////////////////////////////////////////////////////////////////////
+// blockCompress.cpp
+// ========
+// CPU encoder and decoder for the BC1 (DXT1) and BC3 (DXT5) block formats
+//
+//	Colour endpoints come from the principal axis of each block's pixels,
+//	refined once with a least-squares fit against the chosen indices. Block
+//	rows are independent, so they are spread over the worker pool.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "blockCompress.h"
+#include "workerPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// gathers a 4x4 block as RGBA, repeating the last row/column at image edges
+	void FetchBlock(const unsigned char* pixels, int width, int height, int channels, int bx, int by, unsigned char block[16][4])
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			int py = std::min(by * 4 + y, height - 1);
+			for (int x = 0; x < 4; x++)
+			{
+				int px = std::min(bx * 4 + x, width - 1);
+				const unsigned char* src = pixels + ((size_t)py * width + px) * channels;
+				block[y * 4 + x][0] = src[0];
+				block[y * 4 + x][1] = src[1];
+				block[y * 4 + x][2] = src[2];
+				block[y * 4 + x][3] = channels == 4 ? src[3] : 255;
+			}
+		}
+	}
+
+	unsigned short To565(float r, float g, float b)
+	{
+		int r5 = (int)(std::min(std::max(r, 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+		int g6 = (int)(std::min(std::max(g, 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+		int b5 = (int)(std::min(std::max(b, 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+		return (unsigned short)((r5 << 11) | (g6 << 5) | b5);
+	}
+
+	void From565(unsigned short c, int rgb[3])
+	{
+		int r5 = (c >> 11) & 31;
+		int g6 = (c >> 5) & 63;
+		int b5 = c & 31;
+		rgb[0] = (r5 << 3) | (r5 >> 2);
+		rgb[1] = (g6 << 2) | (g6 >> 4);
+		rgb[2] = (b5 << 3) | (b5 >> 2);
+	}
+
+	// the four colours a BC1 block can reference when c0 > c1
+	void Palette(unsigned short c0, unsigned short c1, int palette[4][3])
+	{
+		From565(c0, palette[0]);
+		From565(c1, palette[1]);
+		for (int i = 0; i < 3; i++)
+		{
+			palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+			palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+		}
+	}
+
+	unsigned int PickIndices(const unsigned char block[16][4], const int palette[4][3])
+	{
+		unsigned int indices = 0;
+		for (int p = 0; p < 16; p++)
+		{
+			int best = 0;
+			int bestError = 1 << 30;
+			for (int i = 0; i < 4; i++)
+			{
+				int dr = block[p][0] - palette[i][0];
+				int dg = block[p][1] - palette[i][1];
+				int db = block[p][2] - palette[i][2];
+				int error = dr * dr + dg * dg + db * db;
+				if (error < bestError)
+				{
+					bestError = error;
+					best = i;
+				}
+			}
+			indices |= (unsigned int)best << (p * 2);
+		}
+		return indices;
+	}
+
+	int BlockError(const unsigned char block[16][4], const int palette[4][3], unsigned int indices)
+	{
+		int total = 0;
+		for (int p = 0; p < 16; p++)
+		{
+			const int* c = palette[(indices >> (p * 2)) & 3];
+			for (int i = 0; i < 3; i++)
+				total += (block[p][i] - c[i]) * (block[p][i] - c[i]);
+		}
+		return total;
+	}
+
+	// orders the endpoints for four-colour mode and writes the 8 byte block
+	void WriteColorBlock(unsigned short c0, unsigned short c1, const unsigned char block[16][4], unsigned char* out)
+	{
+		unsigned int indices = 0;
+		if (c0 < c1)
+			std::swap(c0, c1);
+		if (c0 != c1)
+		{
+			int palette[4][3];
+			Palette(c0, c1, palette);
+			indices = PickIndices(block, palette);
+		}
+
+		out[0] = (unsigned char)(c0 & 0xff);
+		out[1] = (unsigned char)(c0 >> 8);
+		out[2] = (unsigned char)(c1 & 0xff);
+		out[3] = (unsigned char)(c1 >> 8);
+		out[4] = (unsigned char)(indices & 0xff);
+		out[5] = (unsigned char)((indices >> 8) & 0xff);
+		out[6] = (unsigned char)((indices >> 16) & 0xff);
+		out[7] = (unsigned char)(indices >> 24);
+	}
+
+	void EncodeColorBlock(const unsigned char block[16][4], unsigned char* out)
+	{
+		// mean and covariance of the block colours
+		float mean[3] = { 0, 0, 0 };
+		for (int p = 0; p < 16; p++)
+			for (int i = 0; i < 3; i++)
+				mean[i] += block[p][i];
+		for (int i = 0; i < 3; i++)
+			mean[i] /= 16.0f;
+
+		float cov[6] = { 0, 0, 0, 0, 0, 0 };
+		for (int p = 0; p < 16; p++)
+		{
+			float r = block[p][0] - mean[0];
+			float g = block[p][1] - mean[1];
+			float b = block[p][2] - mean[2];
+			cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+			cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+		}
+
+		// principal axis by power iteration
+		float axis[3] = { 1.0f, 1.0f, 1.0f };
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+			float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+			float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+			float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+			if (length < 1e-6f)
+				break;
+			axis[0] = x / length;
+			axis[1] = y / length;
+			axis[2] = z / length;
+		}
+
+		float minProj = 1e30f, maxProj = -1e30f;
+		for (int p = 0; p < 16; p++)
+		{
+			float proj = (block[p][0] - mean[0]) * axis[0] + (block[p][1] - mean[1]) * axis[1] + (block[p][2] - mean[2]) * axis[2];
+			minProj = std::min(minProj, proj);
+			maxProj = std::max(maxProj, proj);
+		}
+
+		float axisLengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+		if (axisLengthSq < 1e-6f)
+			axisLengthSq = 1.0f;
+		float lo[3], hi[3];
+		for (int i = 0; i < 3; i++)
+		{
+			lo[i] = mean[i] + axis[i] * minProj / axisLengthSq;
+			hi[i] = mean[i] + axis[i] * maxProj / axisLengthSq;
+		}
+
+		unsigned short c0 = To565(hi[0], hi[1], hi[2]);
+		unsigned short c1 = To565(lo[0], lo[1], lo[2]);
+		if (c0 < c1)
+			std::swap(c0, c1);
+		if (c0 == c1)
+		{
+			WriteColorBlock(c0, c1, block, out);
+			return;
+		}
+
+		int palette[4][3];
+		Palette(c0, c1, palette);
+		unsigned int indices = PickIndices(block, palette);
+		int error = BlockError(block, palette, indices);
+
+		// least-squares refit of both endpoints to the chosen indices
+		static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+		float aa = 0, ab = 0, bb = 0;
+		float ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+		for (int p = 0; p < 16; p++)
+		{
+			float w = weights[(indices >> (p * 2)) & 3];
+			aa += w * w;
+			ab += w * (1.0f - w);
+			bb += (1.0f - w) * (1.0f - w);
+			for (int i = 0; i < 3; i++)
+			{
+				ax[i] += w * block[p][i];
+				bx[i] += (1.0f - w) * block[p][i];
+			}
+		}
+		float det = aa * bb - ab * ab;
+		if (std::fabs(det) > 1e-6f)
+		{
+			float a[3], b[3];
+			for (int i = 0; i < 3; i++)
+			{
+				a[i] = (ax[i] * bb - bx[i] * ab) / det;
+				b[i] = (bx[i] * aa - ax[i] * ab) / det;
+			}
+			unsigned short r0 = To565(a[0], a[1], a[2]);
+			unsigned short r1 = To565(b[0], b[1], b[2]);
+			if (r0 < r1)
+				std::swap(r0, r1);
+			if (r0 != r1)
+			{
+				int refined[4][3];
+				Palette(r0, r1, refined);
+				unsigned int refinedIndices = PickIndices(block, refined);
+				if (BlockError(block, refined, refinedIndices) < error)
+				{
+					c0 = r0;
+					c1 = r1;
+				}
+			}
+		}
+
+		WriteColorBlock(c0, c1, block, out);
+	}
+
+	void EncodeAlphaBlock(const unsigned char block[16][4], unsigned char* out)
+	{
+		int a0 = 0, a1 = 255;
+		for (int p = 0; p < 16; p++)
+		{
+			a0 = std::max(a0, (int)block[p][3]);
+			a1 = std::min(a1, (int)block[p][3]);
+		}
+
+		// eight-value mode: a0 > a1, six interpolated steps in between
+		int values[8];
+		values[0] = a0;
+		values[1] = a1;
+		for (int i = 1; i < 7; i++)
+			values[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+
+		unsigned long long indices = 0;
+		if (a0 != a1)
+		{
+			for (int p = 0; p < 16; p++)
+			{
+				int best = 0;
+				int bestError = 1 << 30;
+				for (int i = 0; i < 8; i++)
+				{
+					int error = std::abs(block[p][3] - values[i]);
+					if (error < bestError)
+					{
+						bestError = error;
+						best = i;
+					}
+				}
+				indices |= (unsigned long long)best << (p * 3);
+			}
+		}
+
+		out[0] = (unsigned char)a0;
+		out[1] = (unsigned char)a1;
+		for (int i = 0; i < 6; i++)
+			out[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xff);
+	}
+
+	void DecodeColorBlock(const unsigned char* in, unsigned char block[16][4])
+	{
+		unsigned short c0 = (unsigned short)(in[0] | (in[1] << 8));
+		unsigned short c1 = (unsigned short)(in[2] | (in[3] << 8));
+		unsigned int indices = in[4] | (in[5] << 8) | (in[6] << 16) | ((unsigned int)in[7] << 24);
+
+		int palette[4][3];
+		Palette(c0, c1, palette);
+		if (c0 <= c1)
+		{
+			// three-colour mode, index 3 is transparent black
+			for (int i = 0; i < 3; i++)
+			{
+				palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+				palette[3][i] = 0;
+			}
+		}
+
+		for (int p = 0; p < 16; p++)
+		{
+			int index = (indices >> (p * 2)) & 3;
+			block[p][0] = (unsigned char)palette[index][0];
+			block[p][1] = (unsigned char)palette[index][1];
+			block[p][2] = (unsigned char)palette[index][2];
+			block[p][3] = (c0 <= c1 && index == 3) ? 0 : 255;
+		}
+	}
+
+	void DecodeAlphaBlock(const unsigned char* in, unsigned char block[16][4])
+	{
+		int a0 = in[0], a1 = in[1];
+		int values[8];
+		values[0] = a0;
+		values[1] = a1;
+		if (a0 > a1)
+		{
+			for (int i = 1; i < 7; i++)
+				values[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+		}
+		else
+		{
+			for (int i = 1; i < 5; i++)
+				values[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+			values[6] = 0;
+			values[7] = 255;
+		}
+
+		unsigned long long indices = 0;
+		for (int i = 0; i < 6; i++)
+			indices |= (unsigned long long)in[2 + i] << (i * 8);
+		for (int p = 0; p < 16; p++)
+			block[p][3] = (unsigned char)values[(indices >> (p * 3)) & 7];
+	}
+
+	void StoreBlock(const unsigned char block[16][4], int width, int height, int bx, int by, unsigned char* rgba)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			int py = by * 4 + y;
+			if (py >= height)
+				break;
+			for (int x = 0; x < 4; x++)
+			{
+				int px = bx * 4 + x;
+				if (px >= width)
+					break;
+				memcpy(rgba + ((size_t)py * width + px) * 4, block[y * 4 + x], 4);
+			}
+		}
+	}
+
+	// runs body(blockRow) for every row of blocks, spread over the pool when there is one
+	void ForEachBlockRow(int height, WorkerPool* workers, const std::function<void(int)> &body)
+	{
+		int blockRows = (height + 3) / 4;
+		if (workers)
+		{
+			workers->ParallelFor(blockRows, body);
+		}
+		else
+		{
+			for (int by = 0; by < blockRows; by++)
+				body(by);
+		}
+	}
+}
+
+size_t BlockCompress::CompressedSize(int width, int height, size_t blockBytes)
+{
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+}
+
+///////////////////////////////////////////////////
+//	EncodeBC1(...)
+//
+//	Compress an RGB or RGBA image to BC1; alpha is
+//	ignored and every block uses four-colour mode
+///////////////////////////////////////////////////
+void BlockCompress::EncodeBC1(const unsigned char* pixels, int width, int height, int channels, unsigned char* out, WorkerPool* workers)
+{
+	int blocksWide = (width + 3) / 4;
+	ForEachBlockRow(height, workers, [=](int by)
+	{
+		unsigned char block[16][4];
+		for (int bx = 0; bx < blocksWide; bx++)
+		{
+			FetchBlock(pixels, width, height, channels, bx, by, block);
+			EncodeColorBlock(block, out + ((size_t)by * blocksWide + bx) * BC1_BLOCK_BYTES);
+		}
+	});
+}
+
+///////////////////////////////////////////////////
+//	EncodeBC3(...)
+//
+//	Compress an RGBA image to BC3: an interpolated
+//	alpha block followed by a BC1 colour block
+///////////////////////////////////////////////////
+void BlockCompress::EncodeBC3(const unsigned char* pixels, int width, int height, unsigned char* out, WorkerPool* workers)
+{
+	int blocksWide = (width + 3) / 4;
+	ForEachBlockRow(height, workers, [=](int by)
+	{
+		unsigned char block[16][4];
+		for (int bx = 0; bx < blocksWide; bx++)
+		{
+			unsigned char* dst = out + ((size_t)by * blocksWide + bx) * BC3_BLOCK_BYTES;
+			FetchBlock(pixels, width, height, 4, bx, by, block);
+			EncodeAlphaBlock(block, dst);
+			EncodeColorBlock(block, dst + 8);
+		}
+	});
+}
+
+void BlockCompress::DecodeBC1(const unsigned char* blocks, int width, int height, unsigned char* rgba)
+{
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+	unsigned char block[16][4];
+	for (int by = 0; by < blocksHigh; by++)
+	{
+		for (int bx = 0; bx < blocksWide; bx++)
+		{
+			DecodeColorBlock(blocks + ((size_t)by * blocksWide + bx) * BC1_BLOCK_BYTES, block);
+			StoreBlock(block, width, height, bx, by, rgba);
+		}
+	}
+}
+
+void BlockCompress::DecodeBC3(const unsigned char* blocks, int width, int height, unsigned char* rgba)
+{
+	int blocksWide = (width + 3) / 4;
+	int blocksHigh = (height + 3) / 4;
+	unsigned char block[16][4];
+	for (int by = 0; by < blocksHigh; by++)
+	{
+		for (int bx = 0; bx < blocksWide; bx++)
+		{
+			const unsigned char* src = blocks + ((size_t)by * blocksWide + bx) * BC3_BLOCK_BYTES;
+			DecodeColorBlock(src + 8, block);
+			DecodeAlphaBlock(src, block);
+			StoreBlock(block, width, height, bx, by, rgba);
+		}
+	}
+}
+
+///////////////////////////////////////////////////
+//	PSNR(...)
+//
+//	Returns 99 dB for identical images so the value
+//	can still be printed and compared
+///////////////////////////////////////////////////
+double BlockCompress::PSNR(const unsigned char* a, int aChannels, const unsigned char* b, int bChannels, int width, int height, int compareChannels)
+{
+	double squaredError = 0.0;
+	size_t pixels = (size_t)width * height;
+	for (size_t p = 0; p < pixels; p++)
+	{
+		for (int c = 0; c < compareChannels; c++)
+		{
+			double diff = (double)a[p * aChannels + c] - (double)b[p * bChannels + c];
+			squaredError += diff * diff;
+		}
+	}
+
+	double mse = squaredError / ((double)pixels * compareChannels);
+	if (mse <= 0.0)
+		return 99.0;
+	return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// config.cpp
+// ========
+// read engine settings from a simple "key = value" text file
+//
+//	Lines starting with '#' are comments. Missing keys fall back to the
+//	value passed by the caller, so the file only needs the overrides.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "config.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	std::string Trim(const std::string &text)
+	{
+		size_t first = text.find_first_not_of(" \t\r\n");
+		if (first == std::string::npos)
+			return "";
+		size_t last = text.find_last_not_of(" \t\r\n");
+		return text.substr(first, last - first + 1);
+	}
+}
+
+///////////////////////////////////////////////////
+//	Load(const char*)
+//
+//	path: settings file to read
+//
+//	Returns false when the file could not be opened;
+//	every getter then returns its fallback value
+///////////////////////////////////////////////////
+bool Config::Load(const char* path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "INFO: no " << path << " found, using default settings" << std::endl;
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		line = Trim(line);
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		size_t split = line.find('=');
+		if (split == std::string::npos)
+			continue;
+
+		values[Trim(line.substr(0, split))] = Trim(line.substr(split + 1));
+	}
+	return true;
+}
+
+std::string Config::GetString(const std::string &key, const std::string &fallback) const
+{
+	auto it = values.find(key);
+	return it == values.end() ? fallback : it->second;
+}
+
+float Config::GetFloat(const std::string &key, float fallback) const
+{
+	auto it = values.find(key);
+	return it == values.end() ? fallback : (float)std::atof(it->second.c_str());
+}
+
+int Config::GetInt(const std::string &key, int fallback) const
+{
+	auto it = values.find(key);
+	return it == values.end() ? fallback : std::atoi(it->second.c_str());
+}
+
+bool Config::GetBool(const std::string &key, bool fallback) const
+{
+	auto it = values.find(key);
+	if (it == values.end())
+		return fallback;
+	return it->second == "1" || it->second == "true" || it->second == "on";
+}
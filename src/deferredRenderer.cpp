@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+// deferredRenderer.cpp
+// ========
+// deferred shading: scene draws fill a G-buffer of albedo, normal and depth,
+// then one full-screen pass lights every covered pixel exactly once
+//
+//	The geometry pass reuses the scene's shader variants with SHADER_GBUFFER
+//	set. The lighting pass evaluates the same bulb, screen and clustered point
+//	lights as the forward shader, reading positions back from depth and the
+//	material's screen light and specular bits from the normal's w, so the
+//	two paths draw the same picture and only differ in cost.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "deferredRenderer.h"
+
+#include <glm/glm/gtc/type_ptr.hpp>
+
+#include <iostream>
+
+bool DeferredRenderer::Initialize(int width, int height, const char* lightingVertexSource, const char* lightingFragmentSource, bool useCache)
+{
+	if (!ShaderLibrary::BuildProgram(lightingVertexSource, lightingFragmentSource, useCache, lighting))
+		return false;
+	glProgramUniform1i(lighting.id, glGetUniformLocation(lighting.id, "gAlbedo"), ALBEDO_UNIT);
+	glProgramUniform1i(lighting.id, glGetUniformLocation(lighting.id, "gNormal"), NORMAL_UNIT);
+	glProgramUniform1i(lighting.id, glGetUniformLocation(lighting.id, "gDepth"), DEPTH_UNIT);
+
+	glGenVertexArrays(1, &emptyVao);
+	this->width = width;
+	this->height = height;
+	CreateTargets();
+	return true;
+}
+
+void DeferredRenderer::Shutdown()
+{
+	DestroyTargets();
+	glDeleteVertexArrays(1, &emptyVao);
+	glDeleteProgram(lighting.id);
+	emptyVao = 0;
+	lighting = ShaderLibrary::Program();
+}
+
+void DeferredRenderer::Resize(int width, int height)
+{
+	if (framebuffer == 0 || width <= 0 || height <= 0 || (width == this->width && height == this->height))
+		return;
+	this->width = width;
+	this->height = height;
+	DestroyTargets();
+	CreateTargets();
+}
+
+void DeferredRenderer::CreateTargets()
+{
+	GLuint* targets[] = { &albedo, &normal, &depth };
+	const GLenum formats[] = { GL_RGBA8, GL_RGBA16F, GL_DEPTH_COMPONENT24 };
+	// on the G-buffer's own unit: this runs mid-frame on a resize, and the
+	// texture manager skips binds of what it believes unit 0 still holds
+	glActiveTexture(GL_TEXTURE0 + ALBEDO_UNIT);
+	for (int i = 0; i < 3; i++)
+	{
+		glGenTextures(1, targets[i]);
+		glBindTexture(GL_TEXTURE_2D, *targets[i]);
+		glTexStorage2D(GL_TEXTURE_2D, 1, formats[i], width, height);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0);
+
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedo, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normal, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+	const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+	glDrawBuffers(2, drawBuffers);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::DEFERRED::G-BUFFER_INCOMPLETE " << width << "x" << height << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DeferredRenderer::DestroyTargets()
+{
+	glDeleteFramebuffers(1, &framebuffer);
+	GLuint targets[] = { albedo, normal, depth };
+	glDeleteTextures(3, targets);
+	framebuffer = albedo = normal = depth = 0;
+}
+
+void DeferredRenderer::BeginGeometry()
+{
+	const GLfloat zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const GLfloat farthest = 1.0f;
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glClearBufferfv(GL_COLOR, 0, zero);
+	glClearBufferfv(GL_COLOR, 1, zero);
+	glClearBufferfv(GL_DEPTH, 0, &farthest);
+}
+
+///////////////////////////////////////////////////
+//	Light(const glm::mat4&, const glm::mat4&)
+//
+//	One full-screen triangle over the default
+//	framebuffer; pixels no draw covered keep the
+//	clear colour
+///////////////////////////////////////////////////
+void DeferredRenderer::Light(const glm::mat4 &view, const glm::mat4 &projection)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+	glProgramUniformMatrix4fv(lighting.id, lighting.inverseViewProjection, 1, GL_FALSE, glm::value_ptr(inverseViewProjection));
+
+	glActiveTexture(GL_TEXTURE0 + ALBEDO_UNIT);
+	glBindTexture(GL_TEXTURE_2D, albedo);
+	glActiveTexture(GL_TEXTURE0 + NORMAL_UNIT);
+	glBindTexture(GL_TEXTURE_2D, normal);
+	glActiveTexture(GL_TEXTURE0 + DEPTH_UNIT);
+	glBindTexture(GL_TEXTURE_2D, depth);
+	glActiveTexture(GL_TEXTURE0);
+
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(lighting.id);
+	glBindVertexArray(emptyVao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+}
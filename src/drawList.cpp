@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// drawList.cpp
+// ========
+// per-frame draw list of the scene objects: worker threads cull and record
+// slices of the scene in parallel into a persistently mapped buffer, the GL
+// thread then submits the merged packets as one instanced draw each
+//
+//	Every slice of SLICE_OBJECTS objects owns the same range of the ring
+//	segment and a packet list of its own, so the jobs never share a byte
+//	they write and need no locks. A slice packs the objects that pass the
+//	frustum test to the front of its range and starts a packet wherever the
+//	mesh or material changes. Merging is only concatenating the lists and
+//	sorting the packets by key, which are few next to the objects.
+//
+//	All packet lists come from the frame arena, each slice's from the arena
+//	of the worker that records it, so recording allocates nothing from the
+//	heap once the arenas have grown to the scene.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "drawList.h"
+#include "allocTracker.h"
+#include "workerPool.h"
+
+#include <glm/glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+///////////////////////////////////////////////////
+//	Initialize(size_t)
+//
+//	Create the persistently mapped object ring
+///////////////////////////////////////////////////
+void DrawList::Initialize(size_t maxObjects)
+{
+	capacity = std::max(maxObjects, (size_t)1);
+	recordSlice = [this](int slice) { RecordSlice(slice); };
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	glBufferStorage(GL_SHADER_STORAGE_BUFFER, capacity * RING_SEGMENTS * sizeof(ObjectData), NULL, flags);
+	mapped = (ObjectData*)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, capacity * RING_SEGMENTS * sizeof(ObjectData), flags);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void DrawList::InitializeHeadless(size_t maxObjects)
+{
+	capacity = std::max(maxObjects, (size_t)1);
+	recordSlice = [this](int slice) { RecordSlice(slice); };
+	headless.resize(capacity * RING_SEGMENTS);
+	mapped = headless.data();
+}
+
+void DrawList::Shutdown()
+{
+	for (GLsync &fence : fences)
+	{
+		if (fence)
+			glDeleteSync(fence);
+		fence = 0;
+	}
+
+	if (buffer)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+		glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		glDeleteBuffers(1, &buffer);
+		buffer = 0;
+	}
+	headless = std::vector<ObjectData>();
+	mapped = nullptr;
+	packets = FrameVector<Packet>();
+	slicePackets.clear();
+	visible = 0;
+}
+
+///////////////////////////////////////////////////
+//	RecordSlice(int)
+//
+//	slice: which SLICE_OBJECTS objects to record
+//
+//	Cull, build and write the model matrices of one
+//	slice and collect its packets, with the view and
+//	arena Record left in 'params'; runs on a worker
+///////////////////////////////////////////////////
+void DrawList::RecordSlice(int slice)
+{
+	AllocScope scope(AllocTag::Render);
+	const glm::vec4* planes = params.planes;
+	float time = params.time;
+	FrameVector<Packet> &out = slicePackets[slice];
+	out = FrameVector<Packet>(ArenaAllocator<Packet>(&params.arena->Local()));
+	out.reserve(SLICE_PACKETS);
+
+	size_t begin = (size_t)slice * SLICE_OBJECTS;
+	size_t end = std::min(begin + SLICE_OBJECTS, std::min(objects.size(), capacity));
+	GLuint base = (GLuint)(segment * capacity + begin);
+	GLuint written = 0;
+	for (size_t i = begin; i < end; i++)
+	{
+		const SceneObject &object = objects[i];
+		float radius = meshes[object.mesh].radius * object.scale;
+		bool inside = true;
+		for (int plane = 0; plane < 6 && inside; plane++)
+			inside = glm::dot(glm::vec3(planes[plane]), object.position) + planes[plane].w >= -radius;
+		if (!inside)
+			continue;
+
+		// spun about its axis, scaled, then moved into place
+		glm::mat4 model = glm::rotate(object.spin * time, object.axis);
+		model[0] *= object.scale;
+		model[1] *= object.scale;
+		model[2] *= object.scale;
+		model[3] = glm::vec4(object.position, 1.0f);
+
+		// whole elements at once, the mapping is write-combined memory
+		ObjectData data = { model, object.color };
+		mapped[base + written] = data;
+
+		unsigned key = object.features << 16 | object.mesh;
+		if (out.empty() || out.back().key != key)
+			out.push_back({ key, object.mesh, object.features, base + written, 0 });
+		out.back().count++;
+		written++;
+	}
+	sliceVisible[slice] = written;
+}
+
+///////////////////////////////////////////////////
+//	Record(const glm::vec4[6], float, WorkerPool*, FrameArena&)
+//
+//	planes: world-space frustum planes, normals inwards
+//	time: seconds the objects have been spinning for
+//	workers: pool the slices run on, nullptr for this
+//	thread alone
+//	arena: the current frame's, for the packet lists
+///////////////////////////////////////////////////
+void DrawList::Record(const glm::vec4 planes[6], float time, WorkerPool* workers, FrameArena &arena)
+{
+	auto start = std::chrono::steady_clock::now();
+	packets.clear();
+	visible = 0;
+	if (!mapped)
+		return;
+
+	// with a frame in flight per segment this is already signalled in practice
+	if (fences[segment])
+	{
+		glClientWaitSync(fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		glDeleteSync(fences[segment]);
+		fences[segment] = 0;
+	}
+
+	int slices = (int)((std::min(objects.size(), capacity) + SLICE_OBJECTS - 1) / SLICE_OBJECTS);
+	if ((int)slicePackets.size() < slices)
+	{
+		slicePackets.resize(slices);
+		sliceVisible.resize(slices);
+	}
+	// a lambda capturing these would outgrow std::function's inline storage
+	// and allocate every frame, so the slices read them from a member
+	params = { planes, time, &arena };
+	if (workers && slices > 1)
+	{
+		workers->ParallelFor(slices, recordSlice);
+	}
+	else
+	{
+		for (int slice = 0; slice < slices; slice++)
+			RecordSlice(slice);
+	}
+
+	size_t packetCount = 0;
+	for (int slice = 0; slice < slices; slice++)
+		packetCount += slicePackets[slice].size();
+	packets = FrameVector<Packet>(ArenaAllocator<Packet>(&arena.Local()));
+	packets.reserve(packetCount);
+	for (int slice = 0; slice < slices; slice++)
+	{
+		visible += sliceVisible[slice];
+		packets.insert(packets.end(), slicePackets[slice].begin(), slicePackets[slice].end());
+	}
+	// same-material packets next to each other; ties go by position in the ring,
+	// which keeps each mesh's slices in order as a stable sort would, without
+	// the buffer std::stable_sort allocates
+	std::sort(packets.begin(), packets.end(), [](const Packet &a, const Packet &b)
+	{
+		return a.key != b.key ? a.key < b.key : a.first < b.first;
+	});
+
+	if (buffer)
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECT_BINDING, buffer);
+	recordMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void DrawList::Finish()
+{
+	if (!mapped)
+		return;
+
+	if (buffer)
+		fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	segment = (segment + 1) % RING_SEGMENTS;
+}
@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameArena.cpp
+// ========
+// bump allocators for data that lives for a frame: culling output, sort
+// keys, draw packets
+//
+//	Nothing is ever freed on its own. An arena hands out memory until its
+//	owner resets it, and grows by whole blocks when a frame asks for more
+//	than it holds; the next reset folds those blocks into one, so after a
+//	few frames at the scene's peak every frame fits in the first block and
+//	allocating costs an add and a compare.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "frameArena.h"
+#include "workerPool.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	// smallest overflow block, so a frame that only just spills does not get many tiny ones
+	const size_t MIN_BLOCK_BYTES = 64 * 1024;
+
+	uintptr_t AlignUp(uintptr_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	}
+}
+
+void LinearArena::Initialize(size_t bytes)
+{
+	blocks.clear();
+	if (bytes > 0)
+		blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[bytes]), bytes });
+	offset = 0;
+	used = 0;
+	highWater = 0;
+}
+
+///////////////////////////////////////////////////
+//	Reset()
+//
+//	Take back everything allocated since the last
+//	Reset; a frame that overflowed leaves one block
+//	the size of all it used behind
+///////////////////////////////////////////////////
+void LinearArena::Reset()
+{
+	highWater = std::max(highWater, used);
+	if (blocks.size() > 1)
+	{
+		size_t size = Capacity();
+		blocks.clear();
+		blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size });
+	}
+	offset = 0;
+	used = 0;
+}
+
+///////////////////////////////////////////////////
+//	Allocate(size_t, size_t)
+//
+//	bytes: size of the allocation
+//	alignment: power of two the address is a multiple of
+///////////////////////////////////////////////////
+void* LinearArena::Allocate(size_t bytes, size_t alignment)
+{
+	if (!blocks.empty())
+	{
+		Block &block = blocks.back();
+		uintptr_t start = (uintptr_t)block.data.get();
+		size_t aligned = (size_t)(AlignUp(start + offset, alignment) - start);
+		if (aligned + bytes <= block.size)
+		{
+			used += aligned + bytes - offset;
+			offset = aligned + bytes;
+			return block.data.get() + aligned;
+		}
+	}
+
+	// overflow for the rest of the frame, never smaller than the block it follows
+	size_t size = std::max({ bytes + alignment, MIN_BLOCK_BYTES, blocks.empty() ? (size_t)0 : blocks.back().size });
+	blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size });
+	offset = 0;
+	return Allocate(bytes, alignment);
+}
+
+size_t LinearArena::Capacity() const
+{
+	size_t capacity = 0;
+	for (const Block &block : blocks)
+		capacity += block.size;
+	return capacity;
+}
+
+///////////////////////////////////////////////////
+//	Initialize(const WorkerPool*, size_t)
+//
+//	workers: pool whose jobs allocate from the arena,
+//	nullptr when only the frame thread does
+//	bytesPerThread: first block of each arena
+///////////////////////////////////////////////////
+void FrameArena::Initialize(const WorkerPool* workers, size_t bytesPerThread)
+{
+	this->workers = workers;
+	int threads = (workers ? workers->ThreadCount() : 0) + 1;
+	for (std::vector<LinearArena> &frameArenas : arenas)
+	{
+		frameArenas = std::vector<LinearArena>(threads);
+		for (LinearArena &arena : frameArenas)
+			arena.Initialize(bytesPerThread);
+	}
+	frame = 0;
+}
+
+void FrameArena::BeginFrame()
+{
+	frame ^= 1;
+	for (LinearArena &arena : arenas[frame])
+		arena.Reset();
+}
+
+LinearArena& FrameArena::Local()
+{
+	std::vector<LinearArena> &frameArenas = arenas[frame];
+	int index = workers ? workers->CurrentThread() : 0;
+	return frameArenas[std::min(index, (int)frameArenas.size() - 1)];
+}
+
+size_t FrameArena::Used() const
+{
+	size_t used = 0;
+	for (const LinearArena &arena : arenas[frame])
+		used += arena.Used();
+	return used;
+}
+
+size_t FrameArena::HighWater() const
+{
+	size_t highWater = 0;
+	for (const LinearArena &arena : arenas[frame])
+		highWater += std::max(arena.HighWater(), arena.Used());
+	return highWater;
+}
+
+size_t FrameArena::Capacity() const
+{
+	size_t capacity = 0;
+	for (const LinearArena &arena : arenas[frame])
+		capacity += arena.Capacity();
+	return capacity;
+}
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuTimer.cpp
+// ========
+// GPU time (GL_TIME_ELAPSED) or samples drawn (GL_SAMPLES_PASSED) over a
+// stretch of commands, read back a few frames late so it never stalls
+///////////////////////////////////////////////////////////////////////////////
+
+#include "gpuTimer.h"
+
+void GpuTimer::Initialize(GLenum target)
+{
+	this->target = target;
+	glGenQueries(QUERY_COUNT, queries);
+}
+
+void GpuTimer::Shutdown()
+{
+	glDeleteQueries(QUERY_COUNT, queries);
+	inFlight = 0;
+	timing = false;
+}
+
+// read back every finished query, oldest first, without waiting on any
+void GpuTimer::Collect()
+{
+	while (inFlight > 0)
+	{
+		GLuint query = queries[(next - inFlight + QUERY_COUNT) % QUERY_COUNT];
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		GLuint64 result = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+		total += target == GL_TIME_ELAPSED ? result / 1e6 : (double)result;
+		samples++;
+		inFlight--;
+	}
+}
+
+void GpuTimer::Begin()
+{
+	Collect();
+	timing = inFlight < QUERY_COUNT;
+	if (timing)
+		glBeginQuery(target, queries[next]);
+}
+
+void GpuTimer::End()
+{
+	if (!timing)
+		return;
+	glEndQuery(target);
+	next = (next + 1) % QUERY_COUNT;
+	inFlight++;
+	timing = false;
+}
+
+bool GpuTimer::Average(double &value)
+{
+	Collect();
+	if (samples == 0)
+		return false;
+	value = total / samples;
+	total = 0.0;
+	samples = 0;
+	return true;
+}
@@ -0,0 +1,201 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightClusters.cpp
+// ========
+// clustered forward lighting: point lights sorted into a grid of view-frustum
+// cells (froxels) on the CPU and handed to the fragment shader in SSBOs
+//
+//	Each cluster's view-space bounding box comes from unprojecting its screen
+//	tile at the near and far depth of its slice, so the same code covers the
+//	perspective and the orthographic camera. Per frame, a light only visits
+//	the slices its depth range covers and tests their tiles four at a time
+//	with SSE. The pairs it produces are grouped by cluster with a counting
+//	sort, giving the shader an offset and count per cluster into one index list.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "lightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <emmintrin.h>
+
+namespace
+{
+	// point on the view-space line through an NDC position at the given depth in front of the eye
+	glm::vec3 AtDepth(const glm::mat4 &inverse, float x, float y, float depth)
+	{
+		glm::vec4 nearPoint = inverse * glm::vec4(x, y, -1.0f, 1.0f);
+		glm::vec4 farPoint = inverse * glm::vec4(x, y, 1.0f, 1.0f);
+		glm::vec3 a = glm::vec3(nearPoint) / nearPoint.w;
+		glm::vec3 b = glm::vec3(farPoint) / farPoint.w;
+		float t = (-depth - a.z) / (b.z - a.z);
+		return a + t * (b - a);
+	}
+}
+
+void LightClusters::Initialize()
+{
+	glGenBuffers(3, buffers);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		boundsMin[axis].resize(CLUSTER_COUNT);
+		boundsMax[axis].resize(CLUSTER_COUNT);
+	}
+	grid.resize(CLUSTER_COUNT * 2);
+}
+
+void LightClusters::Shutdown()
+{
+	glDeleteBuffers(3, buffers);
+	for (GLuint &buffer : buffers)
+		buffer = 0;
+}
+
+int LightClusters::Slice(float depth) const
+{
+	float slice = logf(std::max(depth, nearPlane) / nearPlane) * GRID_Z / logf(farPlane / nearPlane);
+	return std::min((int)slice, GRID_Z - 1);
+}
+
+void LightClusters::ShaderScale(int viewportWidth, int viewportHeight, float scale[4]) const
+{
+	scale[0] = (float)GRID_X / viewportWidth;
+	scale[1] = (float)GRID_Y / viewportHeight;
+	scale[2] = GRID_Z / logf(farPlane / nearPlane);
+	scale[3] = nearPlane;
+}
+
+///////////////////////////////////////////////////
+//	BuildBounds(const glm::mat4&)
+//
+//	View-space box around each froxel: the eight
+//	corners of its tile at its slice's near and far
+//	depth
+///////////////////////////////////////////////////
+void LightClusters::BuildBounds(const glm::mat4 &projection)
+{
+	glm::mat4 inverse = glm::inverse(projection);
+	for (int z = 0; z < GRID_Z; z++)
+	{
+		float sliceNear = nearPlane * powf(farPlane / nearPlane, (float)z / GRID_Z);
+		float sliceFar = nearPlane * powf(farPlane / nearPlane, (float)(z + 1) / GRID_Z);
+		for (int y = 0; y < GRID_Y; y++)
+		{
+			for (int x = 0; x < GRID_X; x++)
+			{
+				glm::vec3 low(1e30f);
+				glm::vec3 high(-1e30f);
+				for (int corner = 0; corner < 8; corner++)
+				{
+					float ndcX = -1.0f + 2.0f * (x + (corner & 1)) / GRID_X;
+					float ndcY = -1.0f + 2.0f * (y + ((corner >> 1) & 1)) / GRID_Y;
+					glm::vec3 point = AtDepth(inverse, ndcX, ndcY, (corner & 4) ? sliceFar : sliceNear);
+					low = glm::min(low, point);
+					high = glm::max(high, point);
+				}
+
+				int cluster = (z * GRID_Y + y) * GRID_X + x;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					boundsMin[axis][cluster] = low[axis];
+					boundsMax[axis][cluster] = high[axis];
+				}
+			}
+		}
+	}
+	boundsProjection = projection;
+}
+
+///////////////////////////////////////////////////
+//	Update(const glm::mat4&, const glm::mat4&, float, float, LinearArena&)
+//
+//	Sphere against box for every light and cluster
+//	in its depth range, then group the hits by
+//	cluster and upload all three buffers
+///////////////////////////////////////////////////
+void LightClusters::Update(const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane, LinearArena &scratch)
+{
+	if (projection != boundsProjection || nearPlane != this->nearPlane || farPlane != this->farPlane)
+	{
+		this->nearPlane = nearPlane;
+		this->farPlane = farPlane;
+		BuildBounds(projection);
+	}
+
+	// cluster << 16 | light before grouping, so at most MAX_LIGHTS lights; starts at
+	// one pair per light, and grows in the arena when lights span clusters
+	FrameVector<unsigned int> pairs{ ArenaAllocator<unsigned int>(&scratch) };
+	pairs.reserve(lights.size());
+	gpuLights.resize(std::max(lights.size(), (size_t)1) * 2);
+	const __m128 zero = _mm_setzero_ps();
+	size_t lightCount = std::min(lights.size(), (size_t)MAX_LIGHTS);
+	for (size_t light = 0; light < lightCount; light++)
+	{
+		const PointLight &source = lights[light];
+		gpuLights[light * 2] = glm::vec4(source.position, source.radius);
+		gpuLights[light * 2 + 1] = glm::vec4(source.color, 1.0f);
+
+		glm::vec3 center = glm::vec3(view * glm::vec4(source.position, 1.0f));
+		float nearest = -center.z - source.radius;
+		float farthest = -center.z + source.radius;
+		if (farthest < nearPlane || nearest > farPlane)
+			continue;
+
+		const __m128 centerX = _mm_set1_ps(center.x);
+		const __m128 centerY = _mm_set1_ps(center.y);
+		const __m128 centerZ = _mm_set1_ps(center.z);
+		const __m128 radius2 = _mm_set1_ps(source.radius * source.radius);
+		int lastSlice = Slice(farthest);
+		for (int z = Slice(nearest); z <= lastSlice; z++)
+		{
+			// GRID_X is a multiple of 4, so groups of four never straddle a row
+			int first = z * GRID_Y * GRID_X;
+			for (int cluster = first; cluster < first + GRID_Y * GRID_X; cluster += 4)
+			{
+				// distance from the center to the box along each axis, zero inside it
+				__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boundsMin[0][cluster]), centerX), _mm_sub_ps(centerX, _mm_loadu_ps(&boundsMax[0][cluster]))), zero);
+				__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boundsMin[1][cluster]), centerY), _mm_sub_ps(centerY, _mm_loadu_ps(&boundsMax[1][cluster]))), zero);
+				__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&boundsMin[2][cluster]), centerZ), _mm_sub_ps(centerZ, _mm_loadu_ps(&boundsMax[2][cluster]))), zero);
+				__m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+				int hits = _mm_movemask_ps(_mm_cmple_ps(distance2, radius2));
+				for (int lane = 0; lane < 4; lane++)
+				{
+					if (hits & (1 << lane))
+						pairs.push_back((unsigned int)(cluster + lane) << 16 | (unsigned int)light);
+				}
+			}
+		}
+	}
+
+	// counting sort of the pairs by cluster
+	std::fill(grid.begin(), grid.end(), 0u);
+	for (unsigned int pair : pairs)
+		grid[(pair >> 16) * 2 + 1]++;
+	unsigned int offset = 0;
+	for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+	{
+		grid[cluster * 2] = offset;
+		offset += grid[cluster * 2 + 1];
+	}
+	indices.resize(std::max(pairs.size(), (size_t)1));
+	unsigned int* cursor = scratch.Allocate<unsigned int>(CLUSTER_COUNT);
+	std::fill(cursor, cursor + CLUSTER_COUNT, 0u);
+	for (unsigned int pair : pairs)
+	{
+		unsigned int cluster = pair >> 16;
+		indices[grid[cluster * 2] + cursor[cluster]++] = pair & 0xffff;
+	}
+	indices.resize(pairs.size());
+
+	// orphan and refill; the buffers are small next to a frame of texture uploads
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[LIGHT_BINDING]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, gpuLights.size() * sizeof(glm::vec4), gpuLights.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[GRID_BINDING]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, grid.size() * sizeof(unsigned int), grid.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[INDEX_BINDING]);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max(indices.size(), (size_t)1) * sizeof(unsigned int), indices.empty() ? nullptr : indices.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	for (GLuint binding = 0; binding < 3; binding++)
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffers[binding]);
+}
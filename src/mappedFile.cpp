@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+// mappedFile.cpp
+// ========
+// read-only memory mapping of a whole file, so asset bytes are read straight
+// from the page cache instead of being copied into heap buffers
+///////////////////////////////////////////////////////////////////////////////
+
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+///////////////////////////////////////////////////
+//	Open(const std::string&)
+//
+//	Map the whole file read-only. Empty files fail, as
+//	neither platform maps zero bytes.
+///////////////////////////////////////////////////
+bool MappedFile::Open(const std::string &path)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+	file = handle;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping)
+	{
+		Close();
+		return false;
+	}
+
+	data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+#else
+	int handle = open(path.c_str(), O_RDONLY);
+	if (handle < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(handle, &info) != 0 || info.st_size == 0)
+	{
+		close(handle);
+		return false;
+	}
+
+	// the mapping keeps its own reference to the file
+	void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, handle, 0);
+	close(handle);
+	if (view == MAP_FAILED)
+		return false;
+
+	madvise(view, (size_t)info.st_size, MADV_SEQUENTIAL);
+	data = (const unsigned char*)view;
+	size = (size_t)info.st_size;
+#endif
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (data)
+		UnmapViewOfFile(data);
+	if (mapping)
+		CloseHandle(mapping);
+	if (file)
+		CloseHandle(file);
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if (data)
+		munmap((void*)data, size);
+#endif
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,355 @@
+///////////////////////////////////////////////////////////////////////////////
+// mipGenerator.cpp
+// ========
+// CPU mip chain generation and downscaling with SSE/AVX box, Kaiser and
+// Lanczos filters, computed in linear light for sRGB colour channels
+//
+//	Every filter is separable: source rows are decoded to linear floats and
+//	filtered horizontally, then output rows are the weighted sum of those
+//	rows. Both passes run over the worker pool one row per job. The vertical
+//	pass is plain streaming multiply-adds, 8 wide with AVX, 4 wide otherwise.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "mipGenerator.h"
+#include "workerPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// the 2x kernels have at most this many taps per output pixel
+	const int MAX_TAPS = 8;
+
+	struct Kernel
+	{
+		int count;
+		float weights[MAX_TAPS];
+	};
+
+	// for every output pixel along one axis, 'count' clamped source indices and their weights
+	struct Taps
+	{
+		int count;
+		std::vector<int> index;
+		std::vector<float> weight;
+	};
+
+	// colour lookups between sRGB bytes and linear floats; the reverse
+	// table is indexed by linear value quantised to 16 bits
+	struct ColorTables
+	{
+		float toLinear[256];
+		float identity[256];
+		unsigned char toSRGB[65536];
+		unsigned char toByte[65536];
+
+		ColorTables()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				float c = i / 255.0f;
+				toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				identity[i] = c;
+			}
+			for (int i = 0; i < 65536; i++)
+			{
+				float l = i / 65535.0f;
+				float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+				toSRGB[i] = (unsigned char)std::min(255.0f, c * 255.0f + 0.5f);
+				toByte[i] = (unsigned char)(l * 255.0f + 0.5f);
+			}
+		}
+	};
+
+	const ColorTables &Tables()
+	{
+		static const ColorTables tables;
+		return tables;
+	}
+
+	double BesselI0(double x)
+	{
+		double sum = 1.0;
+		double term = 1.0;
+		for (int k = 1; k < 32; k++)
+		{
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	Kernel MakeKernel(MipFilter filter)
+	{
+		Kernel kernel;
+		if (filter == MipFilter::Box)
+		{
+			kernel.count = 2;
+			kernel.weights[0] = kernel.weights[1] = 0.5f;
+			return kernel;
+		}
+
+		// sinc with a cutoff at the new Nyquist rate, windowed by Kaiser (alpha 4)
+		// over a radius of two output pixels
+		const double alpha = 4.0;
+		const double radius = 2.0;
+		const double pi = 3.14159265358979323846;
+		kernel.count = MAX_TAPS;
+		double sum = 0.0;
+		double weights[MAX_TAPS];
+		for (int i = 0; i < MAX_TAPS; i++)
+		{
+			double t = ((i - MAX_TAPS / 2) + 0.5) / 2.0;	// distance from the centre in output pixels
+			double sinc = std::sin(pi * t) / (pi * t);
+			double r = t / radius;
+			double window = BesselI0(alpha * std::sqrt(std::max(0.0, 1.0 - r * r))) / BesselI0(alpha);
+			weights[i] = sinc * window;
+			sum += weights[i];
+		}
+		for (int i = 0; i < MAX_TAPS; i++)
+			kernel.weights[i] = (float)(weights[i] / sum);
+		return kernel;
+	}
+
+	// taps of a 2x kernel centred between source pixels 2x and 2x + 1
+	Taps HalveTaps(const Kernel &kernel, int inSize, int outSize)
+	{
+		Taps taps;
+		taps.count = kernel.count;
+		const int first = -(kernel.count / 2 - 1);
+		for (int x = 0; x < outSize; x++)
+		{
+			for (int t = 0; t < kernel.count; t++)
+			{
+				taps.index.push_back(std::min(std::max(x * 2 + first + t, 0), inSize - 1));
+				taps.weight.push_back(kernel.weights[t]);
+			}
+		}
+		return taps;
+	}
+
+	float Sinc(float x)
+	{
+		const float pi = 3.14159265f;
+		return x == 0.0f ? 1.0f : std::sin(pi * x) / (pi * x);
+	}
+
+	// taps of an arbitrary downscale; the filter is stretched by the scale
+	// factor so it stays a low-pass at the output rate
+	Taps ResampleTaps(ResampleFilter filter, int inSize, int outSize)
+	{
+		const float scale = std::max(1.0f, (float)inSize / outSize);
+		const float radius = filter == ResampleFilter::Lanczos ? 3.0f : 0.5f;
+		const float support = radius * scale;
+
+		Taps taps;
+		taps.count = (int)std::ceil(support * 2.0f) + 1;
+		for (int x = 0; x < outSize; x++)
+		{
+			float center = (x + 0.5f) * inSize / outSize - 0.5f;
+			int first = (int)std::floor(center - support) + 1;
+			float sum = 0.0f;
+			size_t start = taps.weight.size();
+			for (int t = 0; t < taps.count; t++)
+			{
+				float d = (first + t - center) / scale;
+				float w;
+				if (filter == ResampleFilter::Lanczos)
+					w = std::fabs(d) < radius ? Sinc(d) * Sinc(d / radius) : 0.0f;
+				else
+					w = d >= -radius && d < radius ? 1.0f : 0.0f;
+				taps.index.push_back(std::min(std::max(first + t, 0), inSize - 1));
+				taps.weight.push_back(w);
+				sum += w;
+			}
+			for (size_t i = start; i < taps.weight.size(); i++)
+				taps.weight[i] /= sum;
+		}
+		return taps;
+	}
+
+	// one source row to linear floats, then filtered horizontally;
+	// rows carry 4 floats of slack so 3 channel pixels can move as __m128
+	void FilterRow(const unsigned char* src, int width, int channels, const float* toLinear, const float* toAlpha,
+		const Taps &taps, int outWidth, std::vector<float> &linear, float* out)
+	{
+		linear.resize((size_t)width * channels + 4);
+		for (int x = 0; x < width; x++)
+		{
+			for (int c = 0; c < channels; c++)
+				linear[(size_t)x * channels + c] = (c == 3 ? toAlpha : toLinear)[src[(size_t)x * channels + c]];
+		}
+
+		for (int x = 0; x < outWidth; x++)
+		{
+			const int* index = &taps.index[(size_t)x * taps.count];
+			const float* weight = &taps.weight[(size_t)x * taps.count];
+			__m128 sum = _mm_setzero_ps();
+			for (int t = 0; t < taps.count; t++)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[t]), _mm_loadu_ps(&linear[(size_t)index[t] * channels])));
+			// the lanes past 'channels' are overwritten by the next pixel
+			_mm_storeu_ps(out + (size_t)x * channels, sum);
+		}
+	}
+
+	// weighted sum of filtered rows, then back to bytes
+	void FilterColumn(const float* const* rows, const float* weights, int taps, int count, int channels,
+		const unsigned char* toColor, const unsigned char* toAlpha, std::vector<float> &sum, unsigned char* dst)
+	{
+		sum.assign((size_t)count, 0.0f);
+		for (int t = 0; t < taps; t++)
+		{
+			const float* row = rows[t];
+			int i = 0;
+#if defined(__AVX__)
+			const __m256 weight8 = _mm256_set1_ps(weights[t]);
+			for (; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(&sum[i], _mm256_add_ps(_mm256_loadu_ps(&sum[i]), _mm256_mul_ps(weight8, _mm256_loadu_ps(row + i))));
+#endif
+			const __m128 weight = _mm_set1_ps(weights[t]);
+			for (; i + 4 <= count; i += 4)
+				_mm_storeu_ps(&sum[i], _mm_add_ps(_mm_loadu_ps(&sum[i]), _mm_mul_ps(weight, _mm_loadu_ps(row + i))));
+			for (; i < count; i++)
+				sum[i] += weights[t] * row[i];
+		}
+
+		// negative lobes can overshoot, so clamp before quantising to 16 bits
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 scale = _mm_set1_ps(65535.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+		int i = 0;
+		int channel = 0;
+		alignas(16) int index[4];
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&sum[i]), zero), one);
+			_mm_store_si128((__m128i*)index, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half)));
+			for (int k = 0; k < 4; k++)
+			{
+				dst[i + k] = (channel == 3 ? toAlpha : toColor)[index[k]];
+				channel = channel + 1 == channels ? 0 : channel + 1;
+			}
+		}
+		for (; i < count; i++)
+		{
+			float v = std::min(std::max(sum[i], 0.0f), 1.0f);
+			dst[i] = (channel == 3 ? toAlpha : toColor)[(int)(v * 65535.0f + 0.5f)];
+			channel = channel + 1 == channels ? 0 : channel + 1;
+		}
+	}
+
+	void Run(WorkerPool* workers, int count, const std::function<void(int)> &body)
+	{
+		if (workers)
+		{
+			workers->ParallelFor(count, body);
+		}
+		else
+		{
+			for (int i = 0; i < count; i++)
+				body(i);
+		}
+	}
+
+	// separable filter: every source row horizontally, then each output row
+	// as the weighted sum of the filtered rows its taps name
+	void Filter(const unsigned char* src, int width, int height, int channels, unsigned char* dst,
+		int outWidth, int outHeight, const Taps &horizontal, const Taps &vertical, bool srgb, WorkerPool* workers)
+	{
+		const ColorTables &tables = Tables();
+		const float* toLinear = srgb ? tables.toLinear : tables.identity;
+		const unsigned char* toColor = srgb ? tables.toSRGB : tables.toByte;
+
+		const size_t rowFloats = (size_t)outWidth * channels;
+		const size_t rowStride = rowFloats + 4;
+
+		std::vector<float> filtered(rowStride * height);
+		Run(workers, height, [&](int y)
+		{
+			thread_local std::vector<float> linear;
+			FilterRow(src + (size_t)y * width * channels, width, channels, toLinear, tables.identity, horizontal,
+				outWidth, linear, &filtered[rowStride * y]);
+		});
+
+		Run(workers, outHeight, [&](int y)
+		{
+			thread_local std::vector<float> sum;
+			thread_local std::vector<const float*> rows;
+			rows.resize(vertical.count);
+			for (int t = 0; t < vertical.count; t++)
+				rows[t] = &filtered[rowStride * vertical.index[(size_t)y * vertical.count + t]];
+			FilterColumn(rows.data(), &vertical.weight[(size_t)y * vertical.count], vertical.count, (int)rowFloats, channels,
+				toColor, tables.toByte, sum, dst + rowFloats * y);
+		});
+	}
+}
+
+///////////////////////////////////////////////////
+//	Downsample(const unsigned char*, int, int, int, unsigned char*, MipFilter, bool, WorkerPool*)
+//
+//	Filter one level into the next. Odd sizes drop their
+//	last row/column under the box filter, which matches
+//	how GL sizes the level below.
+///////////////////////////////////////////////////
+void MipGenerator::Downsample(const unsigned char* src, int width, int height, int channels, unsigned char* dst,
+	MipFilter filter, bool srgb, WorkerPool* workers)
+{
+	const Kernel kernel = MakeKernel(filter);
+	const int outWidth = NextSize(width);
+	const int outHeight = NextSize(height);
+	Filter(src, width, height, channels, dst, outWidth, outHeight,
+		HalveTaps(kernel, width, outWidth), HalveTaps(kernel, height, outHeight), srgb, workers);
+}
+
+///////////////////////////////////////////////////
+//	Resize(const unsigned char*, int, int, int, unsigned char*, int, int, ResampleFilter, bool, WorkerPool*)
+//
+//	Scale an image down to any size, same passes as
+//	Downsample() with per pixel tap tables
+///////////////////////////////////////////////////
+void MipGenerator::Resize(const unsigned char* src, int width, int height, int channels, unsigned char* dst,
+	int outWidth, int outHeight, ResampleFilter filter, bool srgb, WorkerPool* workers)
+{
+	Filter(src, width, height, channels, dst, outWidth, outHeight,
+		ResampleTaps(filter, width, outWidth), ResampleTaps(filter, height, outHeight), srgb, workers);
+}
+
+///////////////////////////////////////////////////
+//	FitSize(int, int, int, int&, int&)
+//
+//	Largest size with the image's aspect ratio whose
+//	longer side is at most maxDimension; 0 means no limit.
+//	Returns false when the image already fits.
+///////////////////////////////////////////////////
+bool MipGenerator::FitSize(int width, int height, int maxDimension, int &outWidth, int &outHeight)
+{
+	outWidth = width;
+	outHeight = height;
+	if (maxDimension <= 0 || std::max(width, height) <= maxDimension)
+		return false;
+
+	double scale = (double)maxDimension / std::max(width, height);
+	outWidth = std::max(1, (int)(width * scale + 0.5));
+	outHeight = std::max(1, (int)(height * scale + 0.5));
+	return true;
+}
+
+const char* MipGenerator::FilterName(MipFilter filter)
+{
+	return filter == MipFilter::Box ? "box" : "kaiser";
+}
+
+const char* MipGenerator::FilterName(ResampleFilter filter)
+{
+	return filter == ResampleFilter::Box ? "box" : "lanczos";
+}
@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+// quaternionCamera.cpp
+// ========
+// camera with a quaternion orientation whose view, projection,
+// view-projection and frustum planes are cached and rebuilt only after
+// the pose or the lens changed, so any number of readers per frame is free
+///////////////////////////////////////////////////////////////////////////////
+
+#include "quaternionCamera.h"
+
+#include <glm/glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const glm::vec3 WORLD_UP(0.0f, 1.0f, 0.0f);
+	const float PITCH_LIMIT = 89.0f;
+
+	// true when the lens values differ, so an unchanged lens keeps its projection
+	bool SetLens(float (&lens)[6], const float (&values)[6])
+	{
+		if (std::equal(values, values + 6, lens))
+			return false;
+		std::copy(values, values + 6, lens);
+		return true;
+	}
+}
+
+QuaternionCamera::QuaternionCamera(glm::vec3 position)
+	: position(position)
+{
+}
+
+void QuaternionCamera::SetPose(const glm::vec3 &position, const glm::quat &orientation)
+{
+	if (position.x != this->position.x || position.y != this->position.y || position.z != this->position.z)
+	{
+		this->position = position;
+		viewDirty = true;
+	}
+	if (orientation.x != this->orientation.x || orientation.y != this->orientation.y ||
+		orientation.z != this->orientation.z || orientation.w != this->orientation.w)
+	{
+		this->orientation = orientation;
+		pitch = glm::degrees(asinf(std::min(std::max(Front().y, -1.0f), 1.0f)));
+		viewDirty = true;
+	}
+}
+
+// the camera looks down its local -z with +y up, as Camera does at yaw -90
+glm::vec3 QuaternionCamera::Front() const
+{
+	return orientation * glm::vec3(0.0f, 0.0f, -1.0f);
+}
+
+glm::vec3 QuaternionCamera::Right() const
+{
+	return orientation * glm::vec3(1.0f, 0.0f, 0.0f);
+}
+
+glm::vec3 QuaternionCamera::Up() const
+{
+	return orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+void QuaternionCamera::Move(Camera_Movement direction, float distance)
+{
+	if (distance == 0.0f)
+		return;
+
+	// same directions as Camera::ProcessKeyboard, including its swapped left/right and up/down
+	if (direction == FORWARD)
+		position += Front() * distance;
+	if (direction == BACKWARD)
+		position -= Front() * distance;
+	if (direction == LEFT)
+		position += Right() * distance;
+	if (direction == RIGHT)
+		position -= Right() * distance;
+	if (direction == UP)
+		position -= WORLD_UP * distance;
+	if (direction == DOWN)
+		position += WORLD_UP * distance;
+	viewDirty = true;
+}
+
+void QuaternionCamera::Turn(float yawDegrees, float pitchDegrees)
+{
+	float newPitch = std::min(std::max(pitch + pitchDegrees, -PITCH_LIMIT), PITCH_LIMIT);
+	pitchDegrees = newPitch - pitch;
+	pitch = newPitch;
+	if (yawDegrees == 0.0f && pitchDegrees == 0.0f)
+		return;
+
+	// yaw about the world up keeps the horizon level, pitch about the camera's own right;
+	// a positive yaw turns towards +x like Camera's
+	orientation = glm::angleAxis(glm::radians(-yawDegrees), WORLD_UP) * orientation *
+		glm::angleAxis(glm::radians(pitchDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	orientation = glm::normalize(orientation);
+	viewDirty = true;
+}
+
+void QuaternionCamera::SetPerspective(float fovyDegrees, float aspect, float nearPlane, float farPlane)
+{
+	const float values[6] = { fovyDegrees, aspect, nearPlane, farPlane, 0.0f, 0.0f };
+	if (SetLens(lens, values) || orthographic)
+	{
+		orthographic = false;
+		projectionDirty = true;
+	}
+}
+
+void QuaternionCamera::SetOrthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane)
+{
+	const float values[6] = { left, right, bottom, top, nearPlane, farPlane };
+	if (SetLens(lens, values) || !orthographic)
+	{
+		orthographic = true;
+		projectionDirty = true;
+	}
+}
+
+const glm::mat4& QuaternionCamera::View()
+{
+	Refresh();
+	return view;
+}
+
+const glm::mat4& QuaternionCamera::Projection()
+{
+	Refresh();
+	return projection;
+}
+
+const glm::mat4& QuaternionCamera::ViewProjection()
+{
+	Refresh();
+	return viewProjection;
+}
+
+const glm::vec4* QuaternionCamera::FrustumPlanes()
+{
+	Refresh();
+	return planes;
+}
+
+bool QuaternionCamera::SphereVisible(const glm::vec3 &center, float radius)
+{
+	Refresh();
+	for (const glm::vec4 &plane : planes)
+	{
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+			return false;
+	}
+	return true;
+}
+
+// rebuilds whatever changed since the last read
+void QuaternionCamera::Refresh()
+{
+	if (viewDirty)
+	{
+		// inverse of the camera's rotation, then of its translation
+		view = glm::mat4_cast(glm::conjugate(orientation));
+		view[3] = view * glm::vec4(-position, 1.0f);
+		viewDirty = false;
+		combinedDirty = true;
+	}
+	if (projectionDirty)
+	{
+		projection = orthographic
+			? glm::ortho(lens[0], lens[1], lens[2], lens[3], lens[4], lens[5])
+			: glm::perspective(glm::radians(lens[0]), lens[1], lens[2], lens[3]);
+		projectionDirty = false;
+		combinedDirty = true;
+	}
+	if (!combinedDirty)
+		return;
+
+	viewProjection = projection * view;
+
+	// Gribb-Hartmann: each plane is the last row of the view-projection
+	// plus or minus one of the others
+	const glm::mat4 &m = viewProjection;
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		int row = i / 2;
+		float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+		glm::vec4 plane(m[0][3] + sign * m[0][row], m[1][3] + sign * m[1][row],
+			m[2][3] + sign * m[2][row], m[3][3] + sign * m[3][row]);
+		planes[i] = plane / glm::length(glm::vec3(plane));
+	}
+	combinedDirty = false;
+}
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderCache.cpp
+// ========
+// on-disk cache of linked shader program binaries, stored under shader_cache/
+// and keyed by the shader sources and the driver that built them
+//
+//	An entry is a small header (magic, binary format, length) followed by the
+//	glGetProgramBinary output. Drivers are free to reject a binary at any time,
+//	so a failed glProgramBinary only means the caller compiles as usual and
+//	overwrites the entry.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "shaderCache.h"
+#include "mappedFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	const char* const CACHE_DIRECTORY = "shader_cache";
+
+	const unsigned int ENTRY_MAGIC = 0x42505347;	// "GSPB"
+	const size_t ENTRY_HEADER_BYTES = 12;
+
+	void PutU32(unsigned char* out, unsigned int value)
+	{
+		out[0] = (unsigned char)(value & 0xff);
+		out[1] = (unsigned char)((value >> 8) & 0xff);
+		out[2] = (unsigned char)((value >> 16) & 0xff);
+		out[3] = (unsigned char)(value >> 24);
+	}
+
+	unsigned int GetU32(const unsigned char* in)
+	{
+		return in[0] | (in[1] << 8) | (in[2] << 16) | ((unsigned int)in[3] << 24);
+	}
+
+	// 64-bit FNV-1a, the terminating zero is hashed too so "ab"+"c" differs from "a"+"bc"
+	void Hash(uint64_t &hash, const char* text)
+	{
+		if (!text)
+			text = "";
+		do
+		{
+			hash ^= (unsigned char)*text;
+			hash *= 0x100000001b3ull;
+		} while (*text++);
+	}
+
+	bool SupportsBinaries()
+	{
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		return formats > 0;
+	}
+}
+
+std::string ShaderCache::Key(const char* vertexSource, const char* fragmentSource)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	Hash(hash, (const char*)glGetString(GL_VENDOR));
+	Hash(hash, (const char*)glGetString(GL_RENDERER));
+	Hash(hash, (const char*)glGetString(GL_VERSION));
+	Hash(hash, vertexSource);
+	Hash(hash, fragmentSource);
+
+	static const char DIGITS[] = "0123456789abcdef";
+	std::string key(16, '0');
+	for (int i = 15; i >= 0; i--, hash >>= 4)
+		key[i] = DIGITS[hash & 0xf];
+	return key;
+}
+
+std::string ShaderCache::EntryPath(const std::string &key)
+{
+	return std::string(CACHE_DIRECTORY) + "/" + key + ".bin";
+}
+
+///////////////////////////////////////////////////
+//	Load(const std::string&, GLuint)
+//
+//	Hand the cached binary to the driver and report
+//	whether it accepted it as a linked program
+///////////////////////////////////////////////////
+bool ShaderCache::Load(const std::string &key, GLuint program)
+{
+	if (!SupportsBinaries())
+		return false;
+
+	MappedFile file;
+	if (!file.Open(EntryPath(key)) || file.Size() < ENTRY_HEADER_BYTES)
+		return false;
+
+	const unsigned char* header = file.Data();
+	size_t length = GetU32(header + 8);
+	if (GetU32(header) != ENTRY_MAGIC || file.Size() != ENTRY_HEADER_BYTES + length)
+		return false;
+
+	glProgramBinary(program, (GLenum)GetU32(header + 4), header + ENTRY_HEADER_BYTES, (GLsizei)length);
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	return linked == GL_TRUE;
+}
+
+bool ShaderCache::Save(const std::string &key, GLuint program)
+{
+	if (!SupportsBinaries())
+		return false;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return false;
+
+	std::vector<unsigned char> entry(ENTRY_HEADER_BYTES + length);
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &written, &format, entry.data() + ENTRY_HEADER_BYTES);
+	if (written <= 0)
+		return false;
+	PutU32(entry.data(), ENTRY_MAGIC);
+	PutU32(entry.data() + 4, format);
+	PutU32(entry.data() + 8, (unsigned int)written);
+
+	std::error_code error;
+	std::filesystem::create_directories(CACHE_DIRECTORY, error);
+
+	// write to a temporary name first so a crash never leaves a torn entry
+	std::string path = EntryPath(key);
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+		file.write((const char*)entry.data(), ENTRY_HEADER_BYTES + written);
+		if (!file)
+			return false;
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	return !error;
+}
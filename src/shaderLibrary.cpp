@@ -0,0 +1,299 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderLibrary.cpp
+// ========
+// compile-time specialised variants of the scene shader, one program per
+// combination of feature bits, so each draw runs only the math it needs
+//
+//	The shared sources test LIT, TEXTURED, SPECULAR, LIGHT_COUNT, CLUSTERED,
+//	GBUFFER and INSTANCED in plain if statements; every variant gets them as #defines ahead of the
+//	source, so the conditions are constant and the compiler strips the dead
+//	branches.
+//
+//	Where the driver offers KHR_parallel_shader_compile (or the ARB version)
+//	only the standard variant is waited for at startup. The others are polled
+//	with GL_COMPLETION_STATUS_KHR once a frame and take over from the standard
+//	variant as they finish, so no frame ever stalls on the compiler. Without it
+//	they are finished a couple per frame instead, so startup still only waits
+//	for the standard variant. Either way a variant that fails is reported and
+//	the standard variant keeps drawing in its place.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "shaderLibrary.h"
+#include "shaderCache.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+	// insert the variant's #defines right after the #version line
+	std::string Specialise(const char* source, unsigned features)
+	{
+		std::string defines =
+			std::string("#define LIT ") + ((features & SHADER_LIT) ? "1" : "0") + "\n" +
+			"#define TEXTURED " + ((features & SHADER_TEXTURED) ? "1" : "0") + "\n" +
+			"#define SPECULAR " + ((features & SHADER_SPECULAR) ? "1" : "0") + "\n" +
+			"#define LIGHT_COUNT " + ((features & SHADER_TWO_LIGHTS) ? "2" : "1") + "\n" +
+			"#define CLUSTERED " + ((features & SHADER_CLUSTERED) ? "1" : "0") + "\n" +
+			"#define GBUFFER " + ((features & SHADER_GBUFFER) ? "1" : "0") + "\n" +
+			"#define INSTANCED " + ((features & SHADER_INSTANCED) ? "1" : "0") + "\n";
+
+		std::string text = source;
+		size_t versionEnd = text.find('\n');
+		text.insert(versionEnd == std::string::npos ? text.size() : versionEnd + 1, defines);
+		return text;
+	}
+
+	GLuint StartCompile(GLenum type, const std::string &source)
+	{
+		GLuint shader = glCreateShader(type);
+		const char* text = source.c_str();
+		glShaderSource(shader, 1, &text, NULL);
+		glCompileShader(shader);
+		return shader;
+	}
+
+	bool CheckCompile(GLuint shader, const char* stage, unsigned features)
+	{
+		int success = 0;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+		if (success)
+			return true;
+
+		char infoLog[512];
+		glGetShaderInfoLog(shader, sizeof(infoLog), NULL, infoLog);
+		std::cout << "ERROR::SHADER::" << stage << "::COMPILATION_FAILED (variant " << features << ")\n" << infoLog << std::endl;
+		return false;
+	}
+
+	void FindUniforms(ShaderLibrary::Program &program)
+	{
+		program.model = glGetUniformLocation(program.id, "model");
+		program.view = glGetUniformLocation(program.id, "view");
+		program.projection = glGetUniformLocation(program.id, "projection");
+		program.objectColor = glGetUniformLocation(program.id, "objectColor");
+		program.uvTransform = glGetUniformLocation(program.id, "uvTransform");
+		program.lightBulbPos = glGetUniformLocation(program.id, "lightBulbPos");
+		program.lightScreenPos = glGetUniformLocation(program.id, "lightScreenPos");
+		program.lightBulbColor = glGetUniformLocation(program.id, "lightBulbColor");
+		program.lightScreenColor = glGetUniformLocation(program.id, "lightScreenColor");
+		program.clusterScale = glGetUniformLocation(program.id, "clusterScale");
+		program.clusterGrid = glGetUniformLocation(program.id, "clusterGrid");
+		program.inverseViewProjection = glGetUniformLocation(program.id, "inverseViewProjection");
+		program.objectBase = glGetUniformLocation(program.id, "objectBase");
+		glProgramUniform1i(program.id, glGetUniformLocation(program.id, "myTexture"), 0);
+		program.ready = true;
+	}
+
+	///////////////////////////////////////////////////
+	//	FinishProgram(ShaderLibrary::Program&, GLuint, GLuint, const std::string&, bool)
+	//
+	//	Report the compile and link status of a program,
+	//	release its shaders and cache its binary. Blocks
+	//	unless the driver has said the program is done.
+	///////////////////////////////////////////////////
+	bool FinishProgram(ShaderLibrary::Program &program, GLuint vertex, GLuint fragment, const std::string &key, bool useCache)
+	{
+		bool compiled = CheckCompile(vertex, "VERTEX", program.features) && CheckCompile(fragment, "FRAGMENT", program.features);
+
+		int linked = 0;
+		glGetProgramiv(program.id, GL_LINK_STATUS, &linked);
+		if (compiled && !linked)
+		{
+			char infoLog[512];
+			glGetProgramInfoLog(program.id, sizeof(infoLog), NULL, infoLog);
+			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED (variant " << program.features << ")\n" << infoLog << std::endl;
+		}
+
+		// the linked program keeps its own copy of the code
+		glDetachShader(program.id, vertex);
+		glDetachShader(program.id, fragment);
+		glDeleteShader(vertex);
+		glDeleteShader(fragment);
+		if (!compiled || !linked)
+			return false;
+
+		if (useCache && !ShaderCache::Save(key, program.id))
+			std::cout << "Shader cache entry not written for program " << key << std::endl;
+		FindUniforms(program);
+		return true;
+	}
+}
+
+unsigned ShaderLibrary::Normalize(unsigned features)
+{
+	features &= SHADER_VARIANT_COUNT - 1;
+	if (!(features & SHADER_LIT) || (features & SHADER_GBUFFER))
+		features &= ~(SHADER_SPECULAR | SHADER_TWO_LIGHTS | SHADER_CLUSTERED);
+	return features;
+}
+
+unsigned ShaderLibrary::Cheapest(unsigned features, const float color[4])
+{
+	if (color[0] == 0.0f && color[1] == 0.0f && color[2] == 0.0f && color[3] == 0.0f)
+		return features & (SHADER_GBUFFER | SHADER_INSTANCED);
+	return Normalize(features);
+}
+
+///////////////////////////////////////////////////
+//	Build(const char*, const char*, bool)
+//
+//	Restore what the cache holds, then start every
+//	missing variant: all compiles, then all links.
+//	Only then is any status queried, which would
+//	otherwise stall on each program in turn
+///////////////////////////////////////////////////
+bool ShaderLibrary::Build(const char* vertexSource, const char* fragmentSource, bool useCache)
+{
+	Destroy();
+	this->useCache = useCache;
+	async = GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+	if (GLEW_KHR_parallel_shader_compile)
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);	// as many as the driver likes
+	else if (GLEW_ARB_parallel_shader_compile)
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+
+	for (unsigned features = 0; features < SHADER_VARIANT_COUNT; features++)
+	{
+		index[features] = -1;
+		if (Normalize(features) != features)
+			continue;
+
+		Program program;
+		program.features = features;
+		program.id = glCreateProgram();
+		index[features] = (int)programs.size();
+		programs.push_back(program);
+
+		std::string vertex = Specialise(vertexSource, features);
+		std::string fragment = Specialise(fragmentSource, features);
+		std::string key;
+		if (useCache)
+		{
+			key = ShaderCache::Key(vertex.c_str(), fragment.c_str());
+			if (ShaderCache::Load(key, programs.back().id))
+			{
+				FindUniforms(programs.back());
+				continue;
+			}
+		}
+		pending.push_back({ programs.size() - 1, key, StartCompile(GL_VERTEX_SHADER, vertex), StartCompile(GL_FRAGMENT_SHADER, fragment) });
+	}
+
+	for (const Pending &build : pending)
+	{
+		GLuint id = programs[build.program].id;
+		glAttachShader(id, build.vertex);
+		glAttachShader(id, build.fragment);
+		if (useCache)
+			glProgramParameteri(id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(id);
+	}
+
+	// the fallbacks stand in for every other variant, so they have to exist now
+	for (size_t i = 0; i < pending.size();)
+	{
+		unsigned features = programs[pending[i].program].features;
+		if (features == Fallback(features))
+		{
+			Finish(pending[i]);
+			pending.erase(pending.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+	bool ok = true;
+	for (unsigned features : { 0u, (unsigned)SHADER_GBUFFER, (unsigned)SHADER_INSTANCED, (unsigned)(SHADER_GBUFFER | SHADER_INSTANCED) })
+		ok = ok && programs[index[Fallback(features)]].ready;
+	return ok;
+}
+
+void ShaderLibrary::Update()
+{
+	int finishes = 0;
+	for (size_t i = 0; i < pending.size() && (async || finishes < FINISHES_PER_UPDATE);)
+	{
+		GLint complete = GL_TRUE;
+		if (async)
+			glGetProgramiv(programs[pending[i].program].id, GL_COMPLETION_STATUS_KHR, &complete);
+		if (complete)
+		{
+			Finish(pending[i]);
+			pending.erase(pending.begin() + i);
+			finishes++;
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+const ShaderLibrary::Program& ShaderLibrary::Get(unsigned features) const
+{
+	const Program &program = programs[index[Normalize(features)]];
+	return program.ready ? program : programs[index[Fallback(features)]];
+}
+
+unsigned ShaderLibrary::Fallback(unsigned features)
+{
+	// a G-buffer draw has to write both targets, so it needs a G-buffer stand-in,
+	// and an instanced draw has no model uniform to fall back on
+	return Normalize(SHADER_STANDARD | (features & (SHADER_GBUFFER | SHADER_INSTANCED)));
+}
+
+bool ShaderLibrary::Finish(const Pending &build)
+{
+	return FinishProgram(programs[build.program], build.vertex, build.fragment, build.key, useCache);
+}
+
+///////////////////////////////////////////////////
+//	BuildProgram(const char*, const char*, bool, Program&, unsigned)
+//
+//	One standalone program, such as a full-screen
+//	pass, built straight away with the same caching
+//	and error reporting as the variants
+///////////////////////////////////////////////////
+bool ShaderLibrary::BuildProgram(const char* vertexSource, const char* fragmentSource, bool useCache, Program &program, unsigned features)
+{
+	program = Program();
+	program.features = features;
+	program.id = glCreateProgram();
+
+	std::string vertexText = Specialise(vertexSource, features);
+	std::string fragmentText = Specialise(fragmentSource, features);
+	std::string key;
+	if (useCache)
+	{
+		key = ShaderCache::Key(vertexText.c_str(), fragmentText.c_str());
+		if (ShaderCache::Load(key, program.id))
+		{
+			FindUniforms(program);
+			return true;
+		}
+	}
+
+	GLuint vertex = StartCompile(GL_VERTEX_SHADER, vertexText);
+	GLuint fragment = StartCompile(GL_FRAGMENT_SHADER, fragmentText);
+	glAttachShader(program.id, vertex);
+	glAttachShader(program.id, fragment);
+	if (useCache)
+		glProgramParameteri(program.id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(program.id);
+	return FinishProgram(program, vertex, fragment, key, useCache);
+}
+
+void ShaderLibrary::Destroy()
+{
+	for (const Pending &build : pending)
+	{
+		glDeleteShader(build.vertex);
+		glDeleteShader(build.fragment);
+	}
+	pending.clear();
+	for (const Program &program : programs)
+		glDeleteProgram(program.id);
+	programs.clear();
+}
@@ -1,2 +1,8 @@
+#include "allocTracker.h"
+
+// decoded images are counted as texture memory whichever thread decodes them
+#define STBI_MALLOC(size) AllocTracker::Malloc(size, AllocTag::Textures)
+#define STBI_REALLOC(pointer, size) AllocTracker::Realloc(pointer, size, AllocTag::Textures)
+#define STBI_FREE(pointer) AllocTracker::Free(pointer)
 #define STB_IMAGE_IMPLEMENTATION
-#include <stb_image/stb_image.h>
\ No newline at end of file
+#include <stb_image/stb_image.h>
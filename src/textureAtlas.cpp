@@ -0,0 +1,378 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureAtlas.cpp
+// ========
+// pack small textures into shared atlas pages (MaxRects) and keep the layout
+// cached on disk next to the compressed texture cache
+//
+//	Every packed image is surrounded by 'padding' texels of its own edge and
+//	placed on a 4 texel grid, so BC blocks never straddle two images and mip
+//	levels down to log2(padding) do not bleed into their neighbours.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "textureAtlas.h"
+
+#include <stb_image/stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	const char* const LAYOUT_FILE = "texture_cache/atlas_layout.txt";
+
+	struct Rect
+	{
+		int page;
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	int AlignUp4(int value)
+	{
+		return (value + 3) & ~3;
+	}
+
+	bool Contains(const Rect &outer, const Rect &inner)
+	{
+		return outer.page == inner.page && inner.x >= outer.x && inner.y >= outer.y
+			&& inner.x + inner.width <= outer.x + outer.width
+			&& inner.y + inner.height <= outer.y + outer.height;
+	}
+
+	// MaxRects: carve 'used' out of every free rectangle it overlaps
+	void SplitFreeRects(std::vector<Rect> &freeRects, const Rect &used)
+	{
+		std::vector<Rect> result;
+		for (const Rect &free : freeRects)
+		{
+			bool overlaps = free.page == used.page
+				&& used.x < free.x + free.width && used.x + used.width > free.x
+				&& used.y < free.y + free.height && used.y + used.height > free.y;
+			if (!overlaps)
+			{
+				result.push_back(free);
+				continue;
+			}
+
+			if (used.x > free.x)
+				result.push_back({ free.page, free.x, free.y, used.x - free.x, free.height });
+			if (used.x + used.width < free.x + free.width)
+				result.push_back({ free.page, used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+			if (used.y > free.y)
+				result.push_back({ free.page, free.x, free.y, free.width, used.y - free.y });
+			if (used.y + used.height < free.y + free.height)
+				result.push_back({ free.page, free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+		}
+
+		// drop rectangles fully inside another one
+		freeRects.clear();
+		for (size_t i = 0; i < result.size(); i++)
+		{
+			bool redundant = false;
+			for (size_t j = 0; j < result.size() && !redundant; j++)
+			{
+				if (i != j && Contains(result[j], result[i]))
+					redundant = !Contains(result[i], result[j]) || j < i;
+			}
+			if (!redundant)
+				freeRects.push_back(result[i]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////
+//	Build(const std::vector<Source>&, int, int, int)
+//
+//	sources: candidate images
+//	pageSize: width and height of each atlas page
+//	maxEntrySize: images larger than this on either side stay on their own
+//	padding: texels of edge repeated around every image
+//
+//	Reuses the layout on disk when it was made for the
+//	same images at the same sizes, otherwise packs anew
+//	and saves the result
+///////////////////////////////////////////////////
+void TextureAtlas::Build(const std::vector<Source> &sources, int pageSize, int maxEntrySize, int padding)
+{
+	// slots are whole 4x4 blocks, so only whole blocks of the page can hold them
+	this->pageSize = pageSize & ~3;
+	this->padding = AlignUp4(padding);
+
+	std::vector<Entry> wanted;
+	for (const Source &source : sources)
+	{
+		int width, height, channels;
+		if (!stbi_info(source.file.c_str(), &width, &height, &channels))
+			continue;
+		if (width > maxEntrySize || height > maxEntrySize ||
+			AlignUp4(width + this->padding * 2) > this->pageSize || AlignUp4(height + this->padding * 2) > this->pageSize)
+			continue;
+		wanted.push_back({ source.file, source.flip, 0, 0, 0, width, height });
+	}
+
+	entries.clear();
+	pageCount = 0;
+	if (wanted.size() < 2)
+		return;	// nothing to share a page with
+
+	if (!LoadLayout(wanted))
+	{
+		Pack(wanted);
+		SaveLayout();
+	}
+}
+
+int TextureAtlas::Find(const std::string &file, bool flip) const
+{
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].file == file && entries[i].flip == flip)
+			return (int)i;
+	}
+	return -1;
+}
+
+///////////////////////////////////////////////////
+//	UVTransform(int, float[4])
+//
+//	transform: receives scale.xy and offset.zw mapping
+//	the image's own 0..1 texture coordinates into the page
+///////////////////////////////////////////////////
+void TextureAtlas::UVTransform(int entry, float transform[4]) const
+{
+	const Entry &e = entries[entry];
+	transform[0] = (float)e.width / pageSize;
+	transform[1] = (float)e.height / pageSize;
+	transform[2] = (float)e.x / pageSize;
+	transform[3] = (float)e.y / pageSize;
+}
+
+///////////////////////////////////////////////////
+//	MaxLevel()
+//
+//	Deepest mip level whose texels still stay inside
+//	the padding around each image
+///////////////////////////////////////////////////
+int TextureAtlas::MaxLevel() const
+{
+	int level = 0;
+	for (int size = padding; size > 1; size >>= 1)
+		level++;
+	return level;
+}
+
+///////////////////////////////////////////////////
+//	LoadPage(int, TextureData&, WorkerPool*, bool)
+//
+//	Fill 'data' with one atlas page: from the texture cache
+//	when its entry is newer than every image on the page,
+//	otherwise by compositing the decoded images
+///////////////////////////////////////////////////
+bool TextureAtlas::LoadPage(int page, TextureData &data, WorkerPool* workers, bool useCache) const
+{
+	std::string path = PagePath(page);
+	if (useCache)
+	{
+		// a repack rewrites the layout, which outdates every page written before it
+		bool fresh = TextureCache::IsFresh(path, LAYOUT_FILE);
+		for (const Entry &entry : entries)
+		{
+			if (entry.page == page && !TextureCache::IsFresh(path, entry.file))
+				fresh = false;
+		}
+		if (fresh && TextureCache::ReadDDS(path, data))
+			return true;
+	}
+
+	int channels = 3;
+	std::vector<unsigned char> pixels;
+	for (const Entry &entry : entries)
+	{
+		if (entry.page != page)
+			continue;
+
+		int width, height, sourceChannels;
+		unsigned char* source = TextureCache::DecodeSource(entry.file, entry.flip, width, height, sourceChannels);
+		if (!source)
+			return false;
+
+		// the first image with alpha promotes the whole page to RGBA
+		if (sourceChannels == 4 && channels == 3)
+		{
+			std::vector<unsigned char> rgba((size_t)pageSize * pageSize * 4, 255);
+			for (size_t p = 0; p < pixels.size() / 3; p++)
+				memcpy(&rgba[p * 4], &pixels[p * 3], 3);
+			pixels.swap(rgba);
+			channels = 4;
+		}
+		if (pixels.empty())
+			pixels.assign((size_t)pageSize * pageSize * channels, 0);
+
+		// copy the image and extrude its edges into the padding
+		for (int y = entry.y - padding; y < entry.y + entry.height + padding; y++)
+		{
+			int sy = std::min(std::max(y - entry.y, 0), height - 1);
+			for (int x = entry.x - padding; x < entry.x + entry.width + padding; x++)
+			{
+				int sx = std::min(std::max(x - entry.x, 0), width - 1);
+				const unsigned char* src = source + ((size_t)sy * width + sx) * sourceChannels;
+				unsigned char* dst = &pixels[((size_t)y * pageSize + x) * channels];
+				memcpy(dst, src, std::min(channels, sourceChannels));
+			}
+		}
+		stbi_image_free(source);
+	}
+	if (pixels.empty())
+		return false;
+
+	if (!useCache)
+	{
+		TextureCache::FromPixels(pixels.data(), pageSize, pageSize, channels, data, workers);
+		return true;
+	}
+
+	TextureCache::Build(pixels.data(), pageSize, pageSize, channels, data, workers);
+	TextureCache::WriteDDS(path, data);
+	return true;
+}
+
+bool TextureAtlas::LoadLayout(const std::vector<Entry> &wanted)
+{
+	std::ifstream file(LAYOUT_FILE);
+	if (!file.is_open())
+		return false;
+
+	int filePageSize = 0, filePadding = 0, count = 0;
+	std::string tag;
+	if (!(file >> tag >> filePageSize >> filePadding >> pageCount >> count) || tag != "atlas")
+		return false;
+	if (filePageSize != pageSize || filePadding != padding || count != (int)wanted.size())
+		return false;
+
+	std::vector<Entry> loaded;
+	std::string line;
+	std::getline(file, line);
+	while (std::getline(file, line))
+	{
+		std::istringstream fields(line);
+		Entry entry;
+		int flip;
+		if (!(fields >> entry.page >> entry.x >> entry.y >> entry.width >> entry.height >> flip))
+			return false;
+		std::getline(fields >> std::ws, entry.file);
+		entry.flip = flip != 0;
+		loaded.push_back(entry);
+	}
+
+	// the layout only holds if every image is still there at the same size
+	for (const Entry &want : wanted)
+	{
+		auto match = std::find_if(loaded.begin(), loaded.end(), [&want](const Entry &e)
+		{
+			return e.file == want.file && e.flip == want.flip && e.width == want.width && e.height == want.height;
+		});
+		if (match == loaded.end())
+			return false;
+	}
+	if (loaded.size() != wanted.size())
+		return false;
+
+	entries = loaded;
+	return true;
+}
+
+void TextureAtlas::SaveLayout() const
+{
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(LAYOUT_FILE).parent_path(), error);
+
+	std::ofstream file(LAYOUT_FILE, std::ios::trunc);
+	file << "atlas " << pageSize << " " << padding << " " << pageCount << " " << entries.size() << "\n";
+	for (const Entry &entry : entries)
+	{
+		file << entry.page << " " << entry.x << " " << entry.y << " " << entry.width << " " << entry.height << " "
+			<< (entry.flip ? 1 : 0) << " " << entry.file << "\n";
+	}
+}
+
+///////////////////////////////////////////////////
+//	Pack(std::vector<Entry>&)
+//
+//	MaxRects with the best short side fit heuristic,
+//	largest images first, opening pages as needed
+///////////////////////////////////////////////////
+void TextureAtlas::Pack(std::vector<Entry> &wanted)
+{
+	std::sort(wanted.begin(), wanted.end(), [](const Entry &a, const Entry &b)
+	{
+		return std::max(a.width, a.height) > std::max(b.width, b.height);
+	});
+
+	std::vector<Rect> freeRects;
+	pageCount = 0;
+	entries.clear();
+
+	for (Entry entry : wanted)
+	{
+		int slotWidth = AlignUp4(entry.width + padding * 2);
+		int slotHeight = AlignUp4(entry.height + padding * 2);
+
+		bool opened = false;
+		for (;;)
+		{
+			int best = -1;
+			int bestShortSide = pageSize;
+			int bestLongSide = pageSize;
+			for (size_t i = 0; i < freeRects.size(); i++)
+			{
+				const Rect &free = freeRects[i];
+				if (free.width < slotWidth || free.height < slotHeight)
+					continue;
+				int leftoverX = free.width - slotWidth;
+				int leftoverY = free.height - slotHeight;
+				int shortSide = std::min(leftoverX, leftoverY);
+				int longSide = std::max(leftoverX, leftoverY);
+				if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+				{
+					best = (int)i;
+					bestShortSide = shortSide;
+					bestLongSide = longSide;
+				}
+			}
+
+			// a page opened for this image and still too small never will be, so
+			// close it again and leave the image on its own
+			if (best < 0 && opened)
+			{
+				freeRects.pop_back();
+				pageCount--;
+				break;
+			}
+			if (best < 0)
+			{
+				freeRects.push_back({ pageCount++, 0, 0, pageSize, pageSize });
+				opened = true;
+				continue;
+			}
+
+			Rect used = { freeRects[best].page, freeRects[best].x, freeRects[best].y, slotWidth, slotHeight };
+			SplitFreeRects(freeRects, used);
+
+			entry.page = used.page;
+			entry.x = used.x + padding;
+			entry.y = used.y + padding;
+			entries.push_back(entry);
+			break;
+		}
+	}
+}
+
+std::string TextureAtlas::PagePath(int page) const
+{
+	return "texture_cache/atlas" + std::to_string(page) + ".dds";
+}
@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureCache.cpp
+// ========
+// on-disk cache of block-compressed textures with their full mip chain,
+// stored as DDS files under texture_cache/
+//
+//	An entry is used as long as it is newer than its source image and was
+//	made with the current mip filter and size budget. Sources larger than
+//	their budget are scaled down with a Lanczos filter before anything else,
+//	so the decode jobs, the cache and the GPU only see the smaller image.
+//	Images with alpha are stored as BC3, everything else as BC1.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "textureCache.h"
+#include "blockCompress.h"
+
+#include <stb_image/stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+namespace
+{
+	const char* const CACHE_DIRECTORY = "texture_cache";
+
+	// DDS header constants, see the DDS_HEADER and DDS_PIXELFORMAT documentation
+	const unsigned int DDS_MAGIC = 0x20534444;	// "DDS "
+	const unsigned int DDSD_CAPS = 0x1;
+	const unsigned int DDSD_HEIGHT = 0x2;
+	const unsigned int DDSD_WIDTH = 0x4;
+	const unsigned int DDSD_PIXELFORMAT = 0x1000;
+	const unsigned int DDSD_MIPMAPCOUNT = 0x20000;
+	const unsigned int DDSD_LINEARSIZE = 0x80000;
+	const unsigned int DDPF_FOURCC = 0x4;
+	const unsigned int DDSCAPS_COMPLEX = 0x8;
+	const unsigned int DDSCAPS_TEXTURE = 0x1000;
+	const unsigned int DDSCAPS_MIPMAP = 0x400000;
+	const unsigned int FOURCC_DXT1 = 0x31545844;	// "DXT1"
+	const unsigned int FOURCC_DXT5 = 0x35545844;	// "DXT5"
+	const size_t DDS_HEADER_BYTES = 128;		// magic + 124 byte header
+	const size_t DDS_MIP_FILTER_OFFSET = 32;	// first dwReserved1 slot, records the mip filter
+	const size_t DDS_MAX_DIMENSION_OFFSET = 36;	// second slot, records the size budget of the source
+
+	// filter that builds every mip chain; entries made with another one are stale
+	MipFilter gMipFilter = MipFilter::Kaiser;
+
+	// load-time size limits; set before the streamer starts, read-only afterwards
+	int gMaxDimension = 0;
+	std::map<std::string, int> gFileMaxDimensions;
+
+	// tag stored in the DDS header, never 0 so entries from before the tag are rebuilt
+	unsigned int MipFilterTag(MipFilter filter)
+	{
+		return filter == MipFilter::Box ? 0x20584f42 : 0x5349414b;	// "BOX " or "KAIS"
+	}
+
+	void PutU32(unsigned char* out, unsigned int value)
+	{
+		out[0] = (unsigned char)(value & 0xff);
+		out[1] = (unsigned char)((value >> 8) & 0xff);
+		out[2] = (unsigned char)((value >> 16) & 0xff);
+		out[3] = (unsigned char)(value >> 24);
+	}
+
+	unsigned int GetU32(const unsigned char* in)
+	{
+		return in[0] | (in[1] << 8) | (in[2] << 16) | ((unsigned int)in[3] << 24);
+	}
+
+	size_t BlockBytes(TextureFormat format)
+	{
+		return format == TextureFormat::BC3 ? BlockCompress::BC3_BLOCK_BYTES : BlockCompress::BC1_BLOCK_BYTES;
+	}
+
+	// lays out the level table for a compressed mip chain down to 1x1, returns its total size
+	size_t LayoutLevels(TextureData &data)
+	{
+		data.levels.clear();
+		size_t offset = 0;
+		int width = data.width;
+		int height = data.height;
+		for (;;)
+		{
+			TextureData::Level level;
+			level.width = width;
+			level.height = height;
+			level.offset = offset;
+			level.size = BlockCompress::CompressedSize(width, height, BlockBytes(data.format));
+			data.levels.push_back(level);
+			offset += level.size;
+
+			if (width == 1 && height == 1)
+				break;
+			width = MipGenerator::NextSize(width);
+			height = MipGenerator::NextSize(height);
+		}
+		return offset;
+	}
+}
+
+///////////////////////////////////////////////////
+//	EntryPath(const std::string&, bool)
+//
+//	Flipped and unflipped decodes of the same image
+//	are different textures, so each gets its own entry
+///////////////////////////////////////////////////
+std::string TextureCache::EntryPath(const std::string &file, bool flip)
+{
+	std::string name = std::filesystem::path(file).filename().string();
+	return std::string(CACHE_DIRECTORY) + "/" + name + (flip ? ".flip.dds" : ".dds");
+}
+
+bool TextureCache::IsFresh(const std::string &entry, const std::string &source)
+{
+	std::error_code error;
+	auto entryTime = std::filesystem::last_write_time(entry, error);
+	if (error)
+		return false;
+	auto sourceTime = std::filesystem::last_write_time(source, error);
+	return error || entryTime >= sourceTime;
+}
+
+unsigned char* TextureCache::DecodeSource(const std::string &file, bool flip, int &width, int &height, int &channels)
+{
+	// decoding from the mapping skips stdio buffering and a heap copy of the compressed file
+	MappedFile source;
+	if (!source.Open(file))
+		return nullptr;
+
+	int fileChannels = 0;
+	if (!stbi_info_from_memory(source.Data(), (int)source.Size(), &width, &height, &fileChannels))
+		return nullptr;
+
+	// grey images are expanded, alpha is kept
+	channels = (fileChannels == 2 || fileChannels == 4) ? 4 : 3;
+	stbi_set_flip_vertically_on_load_thread(flip);
+	return stbi_load_from_memory(source.Data(), (int)source.Size(), &width, &height, &fileChannels, channels);
+}
+
+void TextureCache::SetMaxDimension(int maxDimension)
+{
+	gMaxDimension = maxDimension;
+}
+
+void TextureCache::SetMaxDimension(const std::string &file, int maxDimension)
+{
+	gFileMaxDimensions[file] = maxDimension;
+}
+
+int TextureCache::MaxDimension(const std::string &file)
+{
+	auto limit = gFileMaxDimensions.find(file);
+	return limit != gFileMaxDimensions.end() ? limit->second : gMaxDimension;
+}
+
+///////////////////////////////////////////////////
+//	FitToBudget(const std::string&, const unsigned char*, int&, int&, int, std::vector<unsigned char>&, WorkerPool*)
+//
+//	Lanczos downscale of a decoded source to the longest
+//	side MaxDimension(file) allows, keeping its aspect
+///////////////////////////////////////////////////
+bool TextureCache::FitToBudget(const std::string &file, const unsigned char* pixels, int &width, int &height, int channels,
+	std::vector<unsigned char> &scaled, WorkerPool* workers)
+{
+	int outWidth, outHeight;
+	if (!MipGenerator::FitSize(width, height, MaxDimension(file), outWidth, outHeight))
+		return false;
+
+	scaled.resize((size_t)outWidth * outHeight * channels);
+	MipGenerator::Resize(pixels, width, height, channels, scaled.data(), outWidth, outHeight, ResampleFilter::Lanczos, true, workers);
+	width = outWidth;
+	height = outHeight;
+	return true;
+}
+
+///////////////////////////////////////////////////
+//	Build(...)
+//
+//	pixels: decoded source image
+//	data: receives every mip level, block compressed
+//	workers: pool used to compress block rows in parallel
+///////////////////////////////////////////////////
+void TextureCache::Build(const unsigned char* pixels, int width, int height, int channels, TextureData &data, WorkerPool* workers)
+{
+	data.format = channels == 4 ? TextureFormat::BC3 : TextureFormat::BC1;
+	data.width = width;
+	data.height = height;
+	data.mapping.reset();
+	data.bytes.resize(LayoutLevels(data));
+
+	std::vector<unsigned char> current(pixels, pixels + (size_t)width * height * channels);
+	std::vector<unsigned char> next;
+	for (size_t i = 0; i < data.levels.size(); i++)
+	{
+		const TextureData::Level &level = data.levels[i];
+		unsigned char* out = data.bytes.data() + level.offset;
+		if (data.format == TextureFormat::BC3)
+			BlockCompress::EncodeBC3(current.data(), level.width, level.height, out, workers);
+		else
+			BlockCompress::EncodeBC1(current.data(), level.width, level.height, channels, out, workers);
+
+		if (i + 1 < data.levels.size())
+		{
+			next.resize((size_t)data.levels[i + 1].width * data.levels[i + 1].height * channels);
+			MipGenerator::Downsample(current.data(), level.width, level.height, channels, next.data(), gMipFilter, true, workers);
+			current.swap(next);
+		}
+	}
+}
+
+///////////////////////////////////////////////////
+//	FromPixels(const unsigned char*, int, int, int, TextureData&, WorkerPool*)
+//
+//	Keep decoded pixels uncompressed, with the same CPU
+//	built mip chain a cache entry would get
+///////////////////////////////////////////////////
+void TextureCache::FromPixels(const unsigned char* pixels, int width, int height, int channels, TextureData &data, WorkerPool* workers)
+{
+	data.format = channels == 4 ? TextureFormat::RGBA8 : TextureFormat::RGB8;
+	data.width = width;
+	data.height = height;
+	data.levels.clear();
+	data.mapping.reset();
+
+	size_t offset = 0;
+	for (int w = width, h = height;; w = MipGenerator::NextSize(w), h = MipGenerator::NextSize(h))
+	{
+		TextureData::Level level;
+		level.width = w;
+		level.height = h;
+		level.offset = offset;
+		level.size = (size_t)w * h * channels;
+		data.levels.push_back(level);
+		offset += level.size;
+		if (w == 1 && h == 1)
+			break;
+	}
+
+	data.bytes.resize(offset);
+	std::copy(pixels, pixels + data.levels[0].size, data.bytes.begin());
+	for (size_t i = 1; i < data.levels.size(); i++)
+	{
+		const TextureData::Level &above = data.levels[i - 1];
+		MipGenerator::Downsample(data.bytes.data() + above.offset, above.width, above.height, channels,
+			data.bytes.data() + data.levels[i].offset, gMipFilter, true, workers);
+	}
+}
+
+///////////////////////////////////////////////////
+//	SetMipFilter(MipFilter)
+//
+//	Choose the filter for every mip chain built from now
+//	on. Cache entries remember their filter, so switching
+//	rebuilds them on next use.
+///////////////////////////////////////////////////
+void TextureCache::SetMipFilter(MipFilter filter)
+{
+	gMipFilter = filter;
+}
+
+bool TextureCache::Load(const std::string &file, bool flip, TextureData &data)
+{
+	std::string entry = EntryPath(file, flip);
+	if (!IsFresh(entry, file))
+		return false;
+	return ReadDDS(entry, data) && data.maxDimension == MaxDimension(file);
+}
+
+bool TextureCache::Save(const std::string &file, bool flip, const TextureData &data)
+{
+	std::error_code error;
+	std::filesystem::create_directories(CACHE_DIRECTORY, error);
+	return WriteDDS(EntryPath(file, flip), data);
+}
+
+///////////////////////////////////////////////////
+//	ReadDDS(const std::string&, TextureData&)
+//
+//	Map a cache entry and point 'data' at its levels;
+//	nothing is copied until the upload writes them
+//	into the PBO ring
+///////////////////////////////////////////////////
+bool TextureCache::ReadDDS(const std::string &path, TextureData &data)
+{
+	std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+	if (!file->Open(path) || file->Size() < DDS_HEADER_BYTES)
+		return false;
+
+	const unsigned char* header = file->Data();
+	if (GetU32(header) != DDS_MAGIC)
+		return false;
+
+	unsigned int fourCC = GetU32(header + 84);
+	if (fourCC == FOURCC_DXT1)
+		data.format = TextureFormat::BC1;
+	else if (fourCC == FOURCC_DXT5)
+		data.format = TextureFormat::BC3;
+	else
+		return false;
+
+	data.height = (int)GetU32(header + 12);
+	data.width = (int)GetU32(header + 16);
+	data.maxDimension = (int)GetU32(header + DDS_MAX_DIMENSION_OFFSET);
+	unsigned int mipCount = GetU32(header + 28);
+	if (data.width <= 0 || data.height <= 0)
+		return false;
+
+	if (GetU32(header + DDS_MIP_FILTER_OFFSET) != MipFilterTag(gMipFilter))
+		return false;
+
+	// entries are always written with the complete chain
+	size_t size = LayoutLevels(data);
+	if (mipCount != data.levels.size() || file->Size() != DDS_HEADER_BYTES + size)
+		return false;
+
+	data.bytes.clear();
+	data.mapping = file;
+	data.mappingOffset = DDS_HEADER_BYTES;
+	return true;
+}
+
+bool TextureCache::WriteDDS(const std::string &path, const TextureData &data)
+{
+	if (!data.IsCompressed() || data.levels.empty())
+		return false;
+
+	unsigned char header[DDS_HEADER_BYTES] = {};
+	PutU32(header, DDS_MAGIC);
+	PutU32(header + 4, 124);
+	PutU32(header + 8, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE);
+	PutU32(header + 12, (unsigned int)data.height);
+	PutU32(header + 16, (unsigned int)data.width);
+	PutU32(header + 20, (unsigned int)data.levels[0].size);
+	PutU32(header + 28, (unsigned int)data.levels.size());
+	PutU32(header + DDS_MIP_FILTER_OFFSET, MipFilterTag(gMipFilter));
+	PutU32(header + DDS_MAX_DIMENSION_OFFSET, (unsigned int)data.maxDimension);
+	PutU32(header + 76, 32);
+	PutU32(header + 80, DDPF_FOURCC);
+	PutU32(header + 84, data.format == TextureFormat::BC3 ? FOURCC_DXT5 : FOURCC_DXT1);
+	PutU32(header + 108, DDSCAPS_COMPLEX | DDSCAPS_TEXTURE | DDSCAPS_MIPMAP);
+
+	// write to a temporary name first so a crash never leaves a torn entry
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+		file.write((const char*)header, sizeof(header));
+		file.write((const char*)data.Bytes(), data.ByteCount());
+		if (!file)
+			return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporary, path, error);
+	return !error;
+}
+
+///////////////////////////////////////////////////
+//	Verify(const std::string&, bool, WorkerPool*)
+//
+//	Re-encode a source image, measure the PSNR of its
+//	top level against the (budget scaled) source and check that the
+//	cache entry holds exactly the same bytes. Needs no
+//	GL context.
+///////////////////////////////////////////////////
+TextureCache::VerifyReport TextureCache::Verify(const std::string &file, bool flip, WorkerPool* workers)
+{
+	VerifyReport report;
+
+	int width, height, channels;
+	unsigned char* pixels = DecodeSource(file, flip, width, height, channels);
+	if (!pixels)
+		return report;
+	report.sourceLoaded = true;
+
+	std::vector<unsigned char> scaled;
+	if (FitToBudget(file, pixels, width, height, channels, scaled, workers))
+	{
+		stbi_image_free(pixels);
+		pixels = nullptr;
+	}
+	const unsigned char* source = pixels ? pixels : scaled.data();
+	report.sourceBytes = (size_t)width * height * channels;
+
+	TextureData fresh;
+	Build(source, width, height, channels, fresh, workers);
+	report.levels = (int)fresh.levels.size();
+	report.compressedBytes = fresh.bytes.size();
+
+	std::vector<unsigned char> decoded((size_t)width * height * 4);
+	if (fresh.format == TextureFormat::BC3)
+		BlockCompress::DecodeBC3(fresh.bytes.data(), width, height, decoded.data());
+	else
+		BlockCompress::DecodeBC1(fresh.bytes.data(), width, height, decoded.data());
+	report.psnr = BlockCompress::PSNR(source, channels, decoded.data(), 4, width, height, channels);
+	if (pixels)
+		stbi_image_free(pixels);
+
+	TextureData cached;
+	if (ReadDDS(EntryPath(file, flip), cached))
+	{
+		report.cacheFound = true;
+		report.matchesCache = cached.format == fresh.format && cached.ByteCount() == fresh.ByteCount()
+			&& memcmp(cached.Bytes(), fresh.Bytes(), fresh.ByteCount()) == 0;
+	}
+	return report;
+}
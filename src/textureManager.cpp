@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureManager.cpp
+// ========
+// owns every scene texture behind a handle, keeps the full-resolution ones
+// within a memory budget and drops the least recently used back to their
+// low-resolution mip tail
+//
+//	Textures load on first use and stream in coarse levels first, ordered by
+//	how much of the screen they covered when last drawn. The first upload
+//	also leaves behind a tail holding the levels up to 'tailSize', which is
+//	never evicted, so a texture that falls out of the budget still draws, only
+//	blurrier, until it is streamed back in from the texture cache.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "textureManager.h"
+#include "allocTracker.h"
+
+#include <algorithm>
+#include <iostream>
+
+///////////////////////////////////////////////////
+//	Initialize(TextureStreamer*, size_t, int)
+//
+//	streamer: loads and uploads the textures
+//	budgetBytes: most bytes of full chains and tails kept on the GPU
+//	tailSize: largest side of the levels kept after eviction
+///////////////////////////////////////////////////
+void TextureManager::Initialize(TextureStreamer* streamer, size_t budgetBytes, int tailSize)
+{
+	this->streamer = streamer;
+	budget = budgetBytes;
+	this->tailSize = tailSize;
+
+	const unsigned char pixel[] = { 255, 255, 255 };
+	glGenTextures(1, &white);
+	glBindTexture(GL_TEXTURE_2D, white);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, pixel);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+///////////////////////////////////////////////////
+//	Shutdown()
+//
+//	Delete every texture; call after the streamer's
+//	Shutdown() so no upload finishes afterwards
+///////////////////////////////////////////////////
+void TextureManager::Shutdown()
+{
+	for (Texture &texture : textures)
+	{
+		if (texture.full)
+			glDeleteTextures(1, &texture.full);
+		if (texture.tail)
+			glDeleteTextures(1, &texture.tail);
+	}
+	textures.clear();
+	residentBytes = 0;
+
+	if (white)
+		glDeleteTextures(1, &white);
+	white = 0;
+	std::fill(bound, bound + MAX_UNITS, 0);
+}
+
+///////////////////////////////////////////////////
+//	Load(const char*, bool)
+//
+//	Register an image file; nothing is read until the
+//	texture is first bound
+///////////////////////////////////////////////////
+TextureHandle TextureManager::Load(const char* file, bool flip)
+{
+	Texture texture = {};
+	texture.file = file;
+	texture.flip = flip;
+	texture.state = State::Unloaded;
+	texture.priority = std::make_shared<std::atomic<float>>(0.0f);
+	textures.push_back(texture);
+	return (TextureHandle)textures.size() - 1;
+}
+
+TextureHandle TextureManager::LoadAtlasPage(const TextureAtlas* atlas, int page)
+{
+	Texture texture = {};
+	texture.atlas = atlas;
+	texture.page = page;
+	texture.state = State::Unloaded;
+	texture.priority = std::make_shared<std::atomic<float>>(0.0f);
+	textures.push_back(texture);
+	return (TextureHandle)textures.size() - 1;
+}
+
+///////////////////////////////////////////////////
+//	Bind(TextureHandle, int, float)
+//
+//	handle: texture to sample
+//	unit: texture unit index, 0 for GL_TEXTURE0
+//	screenSize: rough share of the screen height the object
+//	drawn with it covers, sets its streaming priority
+//
+//	Mark the texture used this frame and bind the best
+//	version on the GPU: the full chain, partially loaded
+//	or not, unless its tail is still sharper, else white.
+//	Missing full chains are requested, unless loading
+//	them already failed.
+///////////////////////////////////////////////////
+void TextureManager::Bind(TextureHandle handle, int unit, float screenSize)
+{
+	if (handle < 0 || handle >= (TextureHandle)textures.size())
+		return;
+
+	Texture &texture = textures[handle];
+	texture.screenSize = texture.lastUsedFrame == frame ? std::max(texture.screenSize, screenSize) : screenSize;
+	texture.lastUsedFrame = frame;
+	texture.priority->store(texture.screenSize);
+	if (texture.state == State::Unloaded || texture.state == State::Evicted)
+		Request(handle);
+
+	GLuint name = white;
+	if (texture.full && (!texture.tail || texture.state == State::Resident || texture.fullBaseSize > tailSize))
+		name = texture.full;
+	else if (texture.tail)
+		name = texture.tail;
+	if (bound[unit] != name)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D, name);
+		bound[unit] = name;
+	}
+}
+
+///////////////////////////////////////////////////
+//	Update()
+//
+//	Called once per frame before rendering: starts the
+//	new frame and evicts down to the budget
+///////////////////////////////////////////////////
+void TextureManager::Update()
+{
+	AllocScope scope(AllocTag::Textures);
+	frame++;
+	EvictToBudget();
+}
+
+void TextureManager::Request(TextureHandle handle)
+{
+	AllocScope scope(AllocTag::Textures);
+	Texture &texture = textures[handle];
+	texture.state = State::Loading;
+
+	// the tail survives eviction, so reloads only need the full chain
+	int tail = texture.tail ? 0 : tailSize;
+	auto progress = [this, handle](const TextureStreamer::LoadedTexture &loaded) { Progress(handle, loaded); };
+	if (texture.atlas)
+		streamer->RequestAtlas(texture.atlas, texture.page, tail, texture.priority, progress);
+	else
+		streamer->Request(texture.file.c_str(), texture.flip, tail, texture.priority, progress);
+}
+
+void TextureManager::Progress(TextureHandle handle, const TextureStreamer::LoadedTexture &loaded)
+{
+	Texture &texture = textures[handle];
+	if (loaded.failed)
+	{
+		texture.state = State::Failed;
+		return;
+	}
+	if (!texture.full)
+	{
+		texture.full = loaded.texture;
+		texture.fullBytes = loaded.bytes;
+		residentBytes += loaded.bytes;
+	}
+	if (loaded.tail)
+	{
+		texture.tail = loaded.tail;
+		texture.tailBytes = loaded.tailBytes;
+		residentBytes += loaded.tailBytes;
+	}
+	texture.fullBaseSize = loaded.baseSize;
+	if (loaded.baseLevel == 0)
+		texture.state = State::Resident;
+}
+
+///////////////////////////////////////////////////
+//	EvictToBudget()
+//
+//	Drop full chains, least recently used first, until
+//	the budget is met. Textures drawn last frame stay,
+//	since evicting them would only reload them next frame.
+///////////////////////////////////////////////////
+void TextureManager::EvictToBudget()
+{
+	if (residentBytes <= budget)
+		return;
+
+	std::vector<TextureHandle> candidates;
+	for (TextureHandle i = 0; i < (TextureHandle)textures.size(); i++)
+	{
+		if (textures[i].state == State::Resident && textures[i].lastUsedFrame + 1 < frame)
+			candidates.push_back(i);
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](TextureHandle a, TextureHandle b)
+	{
+		return textures[a].lastUsedFrame < textures[b].lastUsedFrame;
+	});
+
+	for (TextureHandle handle : candidates)
+	{
+		if (residentBytes <= budget)
+			break;
+
+		Texture &texture = textures[handle];
+		for (GLuint &name : bound)
+		{
+			if (name == texture.full)
+				name = 0;
+		}
+		glDeleteTextures(1, &texture.full);
+		texture.full = 0;
+		texture.fullBaseSize = 0;
+		residentBytes -= texture.fullBytes;
+		texture.state = State::Evicted;
+	}
+
+	if (residentBytes > budget && !overBudgetReported)
+	{
+		std::cout << "INFO: textures drawn each frame need " << residentBytes / (1024 * 1024)
+			<< " MB, over the " << budget / (1024 * 1024) << " MB texture budget" << std::endl;
+		overBudgetReported = true;
+	}
+}
@@ -0,0 +1,532 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureStreamer.cpp
+// ========
+// decode images on the worker pool and upload them to GL textures through
+// a ring of persistently mapped pixel buffer objects, a few rows per frame
+//
+//	The GL thread never waits: decoding happens off-thread, each frame copies
+//	at most one budget worth of rows into a ring segment, and a segment is only
+//	reused once the fence placed behind its glTexSubImage2D calls has signaled.
+//
+//	Images arrive with every mip level already built on the CPU, block
+//	compressed when the texture cache is enabled and raw otherwise. Levels go
+//	up smallest first, and GL_TEXTURE_BASE_LEVEL follows the finest complete
+//	one, so a texture is valid to sample from its first 32x32 level on. Each
+//	frame's budget goes to whichever image has the cheapest next level for
+//	its priority: every texture turns up coarse before any one of them
+//	reaches full resolution, and the ones filling the screen sharpen first.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "textureStreamer.h"
+#include "allocTracker.h"
+#include "blockCompress.h"
+#include "textureAtlas.h"
+#include "workerPool.h"
+
+#include <stb_image/stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	// unit used to bind textures while they are being filled, so the units
+	// the scene samples from are only touched once a texture is complete
+	const GLenum UPLOAD_UNIT = GL_TEXTURE31;
+
+	// every segment must hold at least one row of the widest texture
+	const size_t MIN_BUDGET = 1024 * 1024;
+
+	// smallest level handed to the requester; coarser ones are a few bytes and
+	// always arrive in the same frame, so showing them would only flicker
+	const int FIRST_VISIBLE_SIZE = 32;
+
+	void SetSamplingParameters()
+	{
+		//texture wrapping
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		//texture filtering
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+
+	float PriorityOf(const TextureStreamer::PendingImage &image)
+	{
+		return image.priority ? std::max(image.priority->load(), 1.0e-4f) : 1.0e-4f;
+	}
+
+	// texels of the level an image uploads next, per unit of priority
+	float UploadCost(const TextureStreamer::PendingImage &image)
+	{
+		const TextureData::Level &level = image.data.levels[image.level];
+		return (float)level.width * level.height / PriorityOf(image);
+	}
+
+	GLenum InternalFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::BC1:
+			return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case TextureFormat::BC3:
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case TextureFormat::RGBA8:
+			return GL_RGBA8;
+		default:
+			return GL_RGB8;
+		}
+	}
+}
+
+///////////////////////////////////////////////////
+//	Initialize(size_t)
+//
+//	uploadBudgetBytes: most bytes copied into textures per frame
+//	workers: pool that decodes images, one job per image,
+//	and that the cache encoder spreads block rows over
+//	useCache: load from and fill the compressed texture cache
+//
+//	Create the persistently mapped PBO ring
+///////////////////////////////////////////////////
+void TextureStreamer::Initialize(size_t uploadBudgetBytes, WorkerPool* workers, bool useCache)
+{
+	budget = std::max(uploadBudgetBytes, MIN_BUDGET);
+	this->workers = workers;
+
+	// cache entries are S3TC, which every desktop driver exposes as an extension
+	this->useCache = useCache && GLEW_EXT_texture_compression_s3tc;
+	if (useCache && !this->useCache)
+		std::cout << "INFO: S3TC not supported, texture cache disabled" << std::endl;
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &pbo);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, budget * RING_SEGMENTS, NULL, flags);
+	mapped = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, budget * RING_SEGMENTS, flags);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	running = true;
+}
+
+///////////////////////////////////////////////////
+//	Shutdown()
+//
+//	Drop the requests not yet decoding, wait for the
+//	ones that are and release the PBO ring along with
+//	any image that never finished uploading
+///////////////////////////////////////////////////
+void TextureStreamer::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		running = false;
+		requests.clear();
+	}
+	workers->Wait(decoding);
+
+	for (PendingImage &image : decoded)
+		uploads.push_back(image);
+	decoded.clear();
+	// textures already handed out belong to their requester
+	for (PendingImage &image : uploads)
+	{
+		if (image.texture && !image.visible)
+			glDeleteTextures(1, &image.texture);
+	}
+	uploads.clear();
+	requests.clear();
+
+	for (GLsync &fence : fences)
+	{
+		if (fence)
+			glDeleteSync(fence);
+		fence = 0;
+	}
+
+	if (pbo)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glDeleteBuffers(1, &pbo);
+		pbo = 0;
+		mapped = nullptr;
+	}
+}
+
+///////////////////////////////////////////////////
+//	Request(const char*, bool, int, const Priority&, const ProgressCallback&)
+//
+//	file: image to load
+//	flip: flip rows vertically, as stbi_set_flip_vertically_on_load()
+//	tailSize: also build a small texture from the levels up to this size
+//	priority: ordering against other requests, may change while queued
+//	progress: receives the texture each time a finer level is uploaded
+//
+//	Queue the file for decoding
+///////////////////////////////////////////////////
+void TextureStreamer::Request(const char* file, bool flip, int tailSize, const Priority &priority, const ProgressCallback &progress)
+{
+	PendingImage image = {};
+	image.name = file;
+	image.progress = progress;
+	image.priority = priority;
+	image.maxLevel = -1;
+	image.tailSize = tailSize;
+
+	std::string path = file;
+	image.load = [this, path, flip](TextureData &data) { return LoadFile(path, flip, data); };
+	Queue(image);
+}
+
+///////////////////////////////////////////////////
+//	RequestAtlas(const TextureAtlas*, int, int, const Priority&, const ProgressCallback&)
+//
+//	atlas: packed layout, must outlive the request
+//	page: atlas page to composite or load from the cache
+//
+//	Same as Request() for a whole atlas page; its mip chain
+//	stops where the padding no longer hides the neighbours
+///////////////////////////////////////////////////
+void TextureStreamer::RequestAtlas(const TextureAtlas* atlas, int page, int tailSize, const Priority &priority, const ProgressCallback &progress)
+{
+	PendingImage image = {};
+	image.name = "atlas page " + std::to_string(page);
+	image.progress = progress;
+	image.priority = priority;
+	image.maxLevel = atlas->MaxLevel();
+	image.tailSize = tailSize;
+	image.load = [this, atlas, page](TextureData &data) { return atlas->LoadPage(page, data, workers, useCache); };
+	Queue(image);
+}
+
+///////////////////////////////////////////////////
+//	Queue(PendingImage&)
+//
+//	Post a decode job for the image; whichever request
+//	is most urgent by the time the job starts is served
+///////////////////////////////////////////////////
+void TextureStreamer::Queue(PendingImage &image)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		requests.push_back(image);
+	}
+	workers->Run([this] { DecodeNext(); }, &decoding);
+}
+
+///////////////////////////////////////////////////
+//	Update()
+//
+//	Called once per frame on the GL thread. Copies up to
+//	one budget of rows into the next ring segment and
+//	issues glTexSubImage2D/glCompressedTexSubImage2D from
+//	the PBO. Returns immediately when the GPU still reads
+//	that segment.
+///////////////////////////////////////////////////
+void TextureStreamer::Update()
+{
+	AllocScope scope(AllocTag::Textures);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		while (!decoded.empty())
+		{
+			uploads.push_back(decoded.front());
+			decoded.pop_front();
+		}
+	}
+	for (auto image = uploads.begin(); image != uploads.end();)
+	{
+		if (!image->failed)
+		{
+			++image;
+			continue;
+		}
+		LoadedTexture loaded = {};
+		loaded.failed = true;
+		if (image->progress)
+			image->progress(loaded);
+		image = uploads.erase(image);
+	}
+	if (uploads.empty() || !mapped)
+		return;
+
+	// never stall the frame on the GPU: try again next frame instead
+	if (fences[segment])
+	{
+		GLenum state = glClientWaitSync(fences[segment], 0, 0);
+		if (state == GL_TIMEOUT_EXPIRED)
+			return;
+		glDeleteSync(fences[segment]);
+		fences[segment] = 0;
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glActiveTexture(UPLOAD_UNIT);
+
+	size_t used = 0;
+	while (!uploads.empty())
+	{
+		auto next = std::min_element(uploads.begin(), uploads.end(), [](const PendingImage &a, const PendingImage &b)
+		{
+			return UploadCost(a) < UploadCost(b);
+		});
+		if (!UploadRows(*next, used))
+			break;
+
+		ShowLevel(*next);
+		if (next->level < 0)
+			uploads.erase(next);
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (used > 0)
+	{
+		fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		segment = (segment + 1) % RING_SEGMENTS;
+	}
+}
+
+///////////////////////////////////////////////////
+//	IsIdle()
+//
+//	True once every requested image has been uploaded,
+//	or reported to its requester as failed
+///////////////////////////////////////////////////
+bool TextureStreamer::IsIdle()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return requests.empty() && decoding.IsDone() && decoded.empty() && uploads.empty();
+}
+
+///////////////////////////////////////////////////
+//	DecodeNext()
+//
+//	Decode job, one posted per request: runs the loader
+//	of the highest priority request and hands the result
+//	to the GL thread
+///////////////////////////////////////////////////
+void TextureStreamer::DecodeNext()
+{
+	AllocScope scope(AllocTag::Textures);
+	PendingImage image;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (!running || requests.empty())
+			return;
+		auto next = std::max_element(requests.begin(), requests.end(), [](const PendingImage &a, const PendingImage &b)
+		{
+			return PriorityOf(a) < PriorityOf(b);
+		});
+		image = *next;
+		requests.erase(next);
+	}
+
+	// failures go through the GL thread as well, where the requester hears of them
+	if (!image.load(image.data))
+	{
+		std::cout << "Texture failed to load " << image.name << "..." << std::endl;
+		image.failed = true;
+		std::lock_guard<std::mutex> guard(lock);
+		decoded.push_back(image);
+		return;
+	}
+
+	// uploads start from the smallest level the texture samples
+	int levels = (int)image.data.levels.size();
+	image.level = image.maxLevel >= 0 ? std::min(image.maxLevel, levels - 1) : levels - 1;
+	image.row = 0;
+
+	std::lock_guard<std::mutex> guard(lock);
+	decoded.push_back(image);
+}
+
+///////////////////////////////////////////////////
+//	LoadFile(const std::string&, bool, TextureData&)
+//
+//	Decode job loader for a single image file. A cache
+//	miss decodes the source, scales it to its size budget,
+//	compresses it and writes the entry so later launches
+//	skip all of it.
+///////////////////////////////////////////////////
+bool TextureStreamer::LoadFile(const std::string &file, bool flip, TextureData &data)
+{
+	if (useCache && TextureCache::Load(file, flip, data))
+		return true;
+
+	int width, height, channels;
+	unsigned char* pixels = TextureCache::DecodeSource(file, flip, width, height, channels);
+	if (!pixels)
+		return false;
+
+	// drop the full size decode as soon as the scaled copy exists
+	std::vector<unsigned char> scaled;
+	if (TextureCache::FitToBudget(file, pixels, width, height, channels, scaled, workers))
+	{
+		stbi_image_free(pixels);
+		pixels = nullptr;
+	}
+	const unsigned char* source = pixels ? pixels : scaled.data();
+
+	if (useCache)
+	{
+		TextureCache::Build(source, width, height, channels, data, workers);
+		data.maxDimension = TextureCache::MaxDimension(file);
+		if (!TextureCache::Save(file, flip, data))
+			std::cout << "Texture cache entry not written for " << file << std::endl;
+	}
+	else
+	{
+		TextureCache::FromPixels(source, width, height, channels, data, workers);
+	}
+	if (pixels)
+		stbi_image_free(pixels);
+	return true;
+}
+
+///////////////////////////////////////////////////
+//	UploadRows(PendingImage&, size_t&)
+//
+//	image: image at the front of the upload queue
+//	segmentUsed: bytes of the current segment already filled
+//
+//	Copy as many rows (block rows for compressed data) of
+//	the image's current level as fit into the current
+//	segment and upload them. Returns true when the level
+//	is complete.
+///////////////////////////////////////////////////
+bool TextureStreamer::UploadRows(PendingImage &image, size_t &segmentUsed)
+{
+	const TextureData &data = image.data;
+	const bool compressed = data.IsCompressed();
+
+	if (!image.texture)
+	{
+		glGenTextures(1, &image.texture);
+		glBindTexture(GL_TEXTURE_2D, image.texture);
+		SetSamplingParameters();
+		if (image.maxLevel >= 0)
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.maxLevel);
+		glTexStorage2D(GL_TEXTURE_2D, (GLsizei)data.levels.size(), InternalFormat(data.format), data.width, data.height);
+	}
+	else
+	{
+		glBindTexture(GL_TEXTURE_2D, image.texture);
+	}
+
+	const TextureData::Level &level = data.levels[image.level];
+	while (image.row < level.height)
+	{
+		// compressed data moves in whole rows of 4x4 blocks
+		const int rowsPerStep = compressed ? 4 : 1;
+		const size_t stepBytes = compressed
+			? BlockCompress::CompressedSize(level.width, 4, data.format == TextureFormat::BC3 ? BlockCompress::BC3_BLOCK_BYTES : BlockCompress::BC1_BLOCK_BYTES)
+			: (size_t)level.width * (data.format == TextureFormat::RGBA8 ? 4 : 3);
+
+		int stepsLeft = (level.height - image.row + rowsPerStep - 1) / rowsPerStep;
+		int steps = std::min((int)((budget - segmentUsed) / stepBytes), stepsLeft);
+		if (steps <= 0)
+			return false;
+
+		int rows = std::min(steps * rowsPerStep, level.height - image.row);
+		size_t bytes = stepBytes * steps;
+		size_t offset = budget * segment + segmentUsed;
+		memcpy(mapped + offset, data.Bytes() + level.offset + stepBytes * (image.row / rowsPerStep), bytes);
+
+		if (compressed)
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, image.level, 0, image.row, level.width, rows, InternalFormat(data.format), (GLsizei)bytes, (void*)offset);
+		else
+			glTexSubImage2D(GL_TEXTURE_2D, image.level, 0, image.row, level.width, rows, data.format == TextureFormat::RGBA8 ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, (void*)offset);
+
+		segmentUsed += bytes;
+		image.row += rows;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////
+//	ShowLevel(PendingImage&)
+//
+//	Called after a level is complete: clamp sampling to
+//	it and, once it is big enough to be worth drawing,
+//	hand the texture to the requester. After level 0 the
+//	CPU copy is freed.
+///////////////////////////////////////////////////
+void TextureStreamer::ShowLevel(PendingImage &image)
+{
+	const TextureData::Level &level = image.data.levels[image.level];
+	glBindTexture(GL_TEXTURE_2D, image.texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, image.level);
+
+	LoadedTexture loaded = {};
+	loaded.texture = image.texture;
+	loaded.baseLevel = image.level;
+	loaded.baseSize = std::max(level.width, level.height);
+	loaded.bytes = image.data.ByteCount();
+
+	bool show = image.level == 0 || loaded.baseSize >= FIRST_VISIBLE_SIZE;
+	if (show && !image.visible)
+	{
+		loaded.tail = CreateTail(image, loaded.tailBytes);
+		image.visible = true;
+	}
+
+	image.level--;
+	image.row = 0;
+	if (image.level < 0)
+	{
+		image.texture = 0;
+		image.data = TextureData();
+		std::cout << "loaded image " << image.name << "..." << std::endl;
+	}
+
+	if (show && image.progress)
+		image.progress(loaded);
+}
+
+///////////////////////////////////////////////////
+//	CreateTail(const PendingImage&, size_t&)
+//
+//	Copy the levels no larger than the image's tail size
+//	into a texture of their own. They are a few kilobytes,
+//	so they go up directly rather than through the ring.
+///////////////////////////////////////////////////
+GLuint TextureStreamer::CreateTail(const PendingImage &image, size_t &tailBytes)
+{
+	const TextureData &data = image.data;
+	tailBytes = 0;
+
+	size_t first = 0;
+	while (first < data.levels.size() && std::max(data.levels[first].width, data.levels[first].height) > image.tailSize)
+		first++;
+	if (image.tailSize <= 0 || first == data.levels.size())
+		return 0;
+
+	GLuint tail;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glGenTextures(1, &tail);
+	glBindTexture(GL_TEXTURE_2D, tail);
+	SetSamplingParameters();
+	glTexStorage2D(GL_TEXTURE_2D, (GLsizei)(data.levels.size() - first), InternalFormat(data.format),
+		data.levels[first].width, data.levels[first].height);
+
+	for (size_t i = first; i < data.levels.size(); i++)
+	{
+		const TextureData::Level &level = data.levels[i];
+		const unsigned char* bytes = data.Bytes() + level.offset;
+		if (data.IsCompressed())
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, (GLint)(i - first), 0, 0, level.width, level.height, InternalFormat(data.format), (GLsizei)level.size, bytes);
+		else
+			glTexSubImage2D(GL_TEXTURE_2D, (GLint)(i - first), 0, 0, level.width, level.height, data.format == TextureFormat::RGBA8 ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, bytes);
+		tailBytes += level.size;
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+	return tail;
+}
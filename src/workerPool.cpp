@@ -0,0 +1,333 @@
+///////////////////////////////////////////////////////////////////////////////
+// workerPool.cpp
+// ========
+// fixed set of worker threads for splitting CPU-heavy work across cores:
+// jobs with completion counters and dependencies, scheduled by work stealing
+///////////////////////////////////////////////////////////////////////////////
+
+#include "workerPool.h"
+
+#include <algorithm>
+
+namespace
+{
+	// shared between the caller of ParallelFor() and the helpers it posts.
+	// body points at the caller's, which outlives every iteration since the
+	// caller waits for them; the state itself is never freed, only reused once
+	// no helper holds it any more.
+	struct ParallelForState
+	{
+		const std::function<void(int)>* body;
+		int count;
+		std::atomic<int> next{ 0 };
+		std::atomic<int> finished{ 0 };
+		std::atomic<int> helpers{ 0 };		// posted and not yet let go
+		std::mutex lock;
+		std::condition_variable done;
+	};
+
+	void RunIterations(ParallelForState &state)
+	{
+		int index;
+		while ((index = state.next++) < state.count)
+		{
+			(*state.body)(index);
+			if (++state.finished == state.count)
+			{
+				std::lock_guard<std::mutex> guard(state.lock);
+				state.done.notify_all();
+			}
+		}
+	}
+
+	// states of finished loops, taken again once their last helper let go,
+	// so a loop run every frame stops allocating after the first few. The
+	// helpers only carry a plain pointer, which every std::function keeps
+	// without allocating.
+	std::mutex gSpareLock;
+	std::vector<std::unique_ptr<ParallelForState>> gSpareStates;
+
+	std::unique_ptr<ParallelForState> AcquireState()
+	{
+		std::lock_guard<std::mutex> guard(gSpareLock);
+		for (size_t i = 0; i < gSpareStates.size(); i++)
+		{
+			// acquire, so whatever the last helper did before letting go is visible
+			if (gSpareStates[i]->helpers.load(std::memory_order_acquire) == 0)
+			{
+				std::unique_ptr<ParallelForState> state = std::move(gSpareStates[i]);
+				gSpareStates[i] = std::move(gSpareStates.back());
+				gSpareStates.pop_back();
+				state->next = 0;
+				state->finished = 0;
+				return state;
+			}
+		}
+		return std::unique_ptr<ParallelForState>(new ParallelForState);
+	}
+
+	void ReleaseState(std::unique_ptr<ParallelForState> state)
+	{
+		std::lock_guard<std::mutex> guard(gSpareLock);
+		gSpareStates.push_back(std::move(state));
+	}
+
+	// pool and queue of the worker running on this thread, if any
+	thread_local const WorkerPool* tPool = nullptr;
+	thread_local int tWorker = -1;
+}
+
+///////////////////////////////////////////////////
+//	Start(int)
+//
+//	threadCount: workers to create, 0 picks one per
+//	core minus the calling thread
+///////////////////////////////////////////////////
+void WorkerPool::Start(int threadCount)
+{
+	if (threadCount <= 0)
+		threadCount = (int)std::thread::hardware_concurrency() - 1;
+	if (threadCount < 1)
+		threadCount = 1;
+
+	for (int i = 0; i <= threadCount; i++)
+		queues.emplace_back(new Queue);
+	running = true;
+	for (int i = 0; i < threadCount; i++)
+		threads.emplace_back(&WorkerPool::WorkerLoop, this, i);
+}
+
+///////////////////////////////////////////////////
+//	Stop()
+//
+//	Join all workers; jobs still queued are dropped
+///////////////////////////////////////////////////
+void WorkerPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		running = false;
+	}
+	wake.notify_all();
+	for (std::thread &thread : threads)
+		thread.join();
+	threads.clear();
+	queues.clear();
+	queued = 0;
+}
+
+///////////////////////////////////////////////////
+//	Run(std::function<void()>, JobCounter*, JobCounter*)
+//
+//	job: work to run on any worker
+//	counter: raised now and lowered once the job has
+//	run, for Wait() or as the 'after' of other jobs
+//	after: the job is held back until this counter
+//	drops to zero
+///////////////////////////////////////////////////
+void WorkerPool::Run(std::function<void()> job, JobCounter* counter, JobCounter* after)
+{
+	if (counter)
+		counter->pending++;
+
+	if (after)
+	{
+		std::lock_guard<std::mutex> guard(after->lock);
+		if (after->pending > 0)
+		{
+			Job held = { std::move(job), counter };
+			after->waiting.push_back([this, held] { Push(held); });
+			return;
+		}
+	}
+	Push({ std::move(job), counter });
+}
+
+///////////////////////////////////////////////////
+//	Wait(JobCounter&)
+//
+//	Runs queued jobs on the calling thread until every
+//	job of 'counter' has finished, so a worker waiting
+//	on its own jobs keeps the pool busy instead of
+//	blocking it
+///////////////////////////////////////////////////
+void WorkerPool::Wait(JobCounter &counter)
+{
+	int index = tPool == this ? tWorker : (int)threads.size();
+	while (counter.pending > 0)
+	{
+		Job job;
+		if (Pop(index, job))
+			Execute(job);
+		else
+			std::this_thread::yield();
+	}
+	std::lock_guard<std::mutex> guard(counter.lock);
+}
+
+///////////////////////////////////////////////////
+//	ParallelFor(int, const std::function<void(int)>&)
+//
+//	count: number of iterations
+//	body: called once for every index in [0, count)
+//
+//	Runs the loop on the workers and the calling thread
+//	and returns once every iteration has finished. The
+//	caller always takes part, so nested calls from a
+//	worker cannot deadlock the pool, and it only waits
+//	for iterations under way, never for helpers still
+//	queued behind unrelated jobs.
+///////////////////////////////////////////////////
+void WorkerPool::ParallelFor(int count, const std::function<void(int)> &body)
+{
+	if (count <= 0)
+		return;
+
+	std::unique_ptr<ParallelForState> state = AcquireState();
+	state->body = &body;
+	state->count = count;
+
+	int helpers = std::min(count - 1, (int)threads.size());
+	state->helpers = helpers;
+	ParallelForState* shared = state.get();
+	for (int i = 0; i < helpers; i++)
+	{
+		Run([shared]
+		{
+			RunIterations(*shared);
+			shared->helpers.fetch_sub(1, std::memory_order_release);
+		});
+	}
+
+	RunIterations(*state);
+
+	{
+		std::unique_lock<std::mutex> guard(state->lock);
+		state->done.wait(guard, [&state] { return state->finished == state->count; });
+	}
+	ReleaseState(std::move(state));
+}
+
+int WorkerPool::ThreadCount() const
+{
+	return (int)threads.size();
+}
+
+int WorkerPool::CurrentThread() const
+{
+	return tPool == this ? tWorker : (int)threads.size();
+}
+
+// a worker keeps its own jobs, any other thread shares the last queue
+void WorkerPool::Push(Job job)
+{
+	Queue &queue = *queues[tPool == this ? tWorker : threads.size()];
+	{
+		std::lock_guard<std::mutex> guard(queue.lock);
+		queue.PushBack(std::move(job));
+	}
+	queued++;
+
+	// the sleeper raises 'sleeping' before checking 'queued' and this side
+	// the other way round, so one of the two always sees the other
+	if (sleeping > 0)
+	{
+		std::lock_guard<std::mutex> guard(sleepLock);
+		wake.notify_one();
+	}
+}
+
+// newest job of the thread's own queue, else the oldest of the shared
+// queue, else the oldest job of another worker, starting after this one
+bool WorkerPool::Pop(int index, Job &job)
+{
+	if (queued == 0)
+		return false;
+
+	int count = (int)queues.size();
+	for (int i = 0; i < count; i++)
+	{
+		int victim = (index + i) % count;
+		Queue &queue = *queues[victim];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (queue.count == 0)
+			continue;
+		if (i == 0 && victim < (int)threads.size())
+			job = queue.PopBack();
+		else
+			job = queue.PopFront();
+		queued--;
+		return true;
+	}
+	return false;
+}
+
+void WorkerPool::Queue::PushBack(Job job)
+{
+	if (count == jobs.size())
+	{
+		// unwrap into twice the room, oldest first
+		std::vector<Job> grown(std::max(jobs.size() * 2, (size_t)16));
+		for (size_t i = 0; i < count; i++)
+			grown[i] = std::move(jobs[(head + i) & (jobs.size() - 1)]);
+		jobs.swap(grown);
+		head = 0;
+	}
+	jobs[(head + count) & (jobs.size() - 1)] = std::move(job);
+	count++;
+}
+
+WorkerPool::Job WorkerPool::Queue::PopBack()
+{
+	count--;
+	return std::move(jobs[(head + count) & (jobs.size() - 1)]);
+}
+
+WorkerPool::Job WorkerPool::Queue::PopFront()
+{
+	Job job = std::move(jobs[head]);
+	head = (head + 1) & (jobs.size() - 1);
+	count--;
+	return job;
+}
+
+// runs the job, then releases the jobs waiting on its counter if it was the last
+void WorkerPool::Execute(Job &job)
+{
+	job.work();
+
+	JobCounter* counter = job.counter;
+	if (!counter)
+		return;
+
+	// lowered under the lock, which Wait() takes before returning, so
+	// the counter is not touched any more once its owner may free it
+	std::vector<std::function<void()>> ready;
+	{
+		std::lock_guard<std::mutex> guard(counter->lock);
+		if (--counter->pending == 0)
+			ready.swap(counter->waiting);
+	}
+	for (std::function<void()> &push : ready)
+		push();
+}
+
+void WorkerPool::WorkerLoop(int index)
+{
+	tPool = this;
+	tWorker = index;
+	while (running)
+	{
+		Job job;
+		if (Pop(index, job))
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> guard(sleepLock);
+		sleeping++;
+		wake.wait(guard, [this] { return !running || queued > 0; });
+		sleeping--;
+	}
+}